@@ -0,0 +1,542 @@
+//
+//  CSV.c
+//  DataStructure
+//
+
+#include "CSV.h"
+#include <limits.h>
+
+#if defined(__AVX2__)
+#define CSV_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSV_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define CSV_BLOCK_SIZE 64
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Table Structure
+
+struct _csv_table {
+    // Shares the buffer of the String the table is made from, NULL if made from bytes
+    String *pStr;
+    const char *pData;
+    long long length;
+    int rowCount;
+    int columnCount;
+    int columnCapacity;
+    // Per column, Array of long long and Array of int
+    Array **ppOffsets;
+    Array **ppLengths;
+    // Column of the next field in the current row
+    int column;
+};
+
+#pragma mark - Inner Function
+
+static int lowestBit(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return (int)index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)mask)) {
+        return (int)index;
+    }
+    _BitScanForward(&index, (unsigned long)(mask >> 32));
+    return (int)index + 32;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Bit i is the parity of the set bits up to and including bit i
+static uint64_t prefixXor(uint64_t mask) {
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+// Set bit i of each mask if byte i of the 64 byte block is a quote, a separator or new line, or a new line
+static void structuralMasks(const char *pBlock, char separator, uint64_t *pQuotes, uint64_t *pEnds, uint64_t *pNewLines) {
+    uint64_t quotes = 0, ends = 0, newLines = 0;
+    
+#if defined(CSV_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i sep = _mm256_set1_epi8(separator);
+    const __m256i newLine = _mm256_set1_epi8('\n');
+    
+    for (int i = 0; i < CSV_BLOCK_SIZE; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *)(pBlock + i));
+        uint64_t isQuote = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, quote));
+        uint64_t isSep = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, sep));
+        uint64_t isNewLine = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newLine));
+        quotes |= isQuote << i;
+        ends |= (isSep | isNewLine) << i;
+        newLines |= isNewLine << i;
+    }
+#elif defined(CSV_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i sep = _mm_set1_epi8(separator);
+    const __m128i newLine = _mm_set1_epi8('\n');
+    
+    for (int i = 0; i < CSV_BLOCK_SIZE; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(pBlock + i));
+        uint64_t isQuote = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote));
+        uint64_t isSep = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, sep));
+        uint64_t isNewLine = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newLine));
+        quotes |= isQuote << i;
+        ends |= (isSep | isNewLine) << i;
+        newLines |= isNewLine << i;
+    }
+#else
+    for (int i = 0; i < CSV_BLOCK_SIZE; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        char ch = pBlock[i];
+        if (ch == '"') {
+            quotes |= bit;
+        } else if (ch == '\n') {
+            ends |= bit;
+            newLines |= bit;
+        } else if (ch == separator) {
+            ends |= bit;
+        }
+    }
+#endif
+    
+    *pQuotes = quotes;
+    *pEnds = ends;
+    *pNewLines = newLines;
+}
+
+// Append an item, double the capacity when growing
+static bool pushItem(Array *pArr, const void *pItem) {
+    if (pArr->length == pArr->capacity) {
+        if (pArr->capacity > INT_MAX / 2) {
+            return false;
+        }
+        if (!ArrayReserve(pArr, pArr->capacity < 64 ? 64 : pArr->capacity * 2)) {
+            return false;
+        }
+    }
+    
+    memcpy((char *)pArr->pData + (size_t)pArr->length * pArr->itemSize, pItem, pArr->itemSize);
+    pArr->length++;
+    
+    return true;
+}
+
+static bool pushField(CSVTable *pTable, int column, long long offset, int length) {
+    return pushItem(pTable->ppOffsets[column], &offset) && pushItem(pTable->ppLengths[column], &length);
+}
+
+// Add a column whose fields are empty for the rows before
+static bool addColumn(CSVTable *pTable) {
+    if (pTable->columnCount == pTable->columnCapacity) {
+        int capacity = pTable->columnCapacity < 8 ? 8 : pTable->columnCapacity * 2;
+        Array **ppOffsets = realloc(pTable->ppOffsets, capacity * sizeof(Array *));
+        if (!ppOffsets) {
+            return false;
+        }
+        pTable->ppOffsets = ppOffsets;
+        Array **ppLengths = realloc(pTable->ppLengths, capacity * sizeof(Array *));
+        if (!ppLengths) {
+            return false;
+        }
+        pTable->ppLengths = ppLengths;
+        pTable->columnCapacity = capacity;
+    }
+    
+    int column = pTable->columnCount;
+    Array *pOffsets = ArrayInit(sizeof(long long));
+    Array *pLengths = ArrayInit(sizeof(int));
+    if (!pOffsets || !pLengths || !ArrayReserve(pOffsets, pTable->rowCount) || !ArrayReserve(pLengths, pTable->rowCount)) {
+        ArrayDestroy(pOffsets);
+        ArrayDestroy(pLengths);
+        return false;
+    }
+    if (pTable->rowCount > 0) {
+        memset(pOffsets->pData, 0, (size_t)pTable->rowCount * sizeof(long long));
+        memset(pLengths->pData, 0, (size_t)pTable->rowCount * sizeof(int));
+    }
+    pOffsets->length = pTable->rowCount;
+    pLengths->length = pTable->rowCount;
+    
+    pTable->ppOffsets[column] = pOffsets;
+    pTable->ppLengths[column] = pLengths;
+    pTable->columnCount++;
+    
+    return true;
+}
+
+// Record the field in [start, end) of the text, which ends the row if endsRow is true
+static bool addField(CSVTable *pTable, long long start, long long end, bool endsRow) {
+    const char *pData = pTable->pData;
+    
+    if (endsRow && end > start && pData[end - 1] == '\r') {
+        end--;
+    }
+    if (endsRow && pTable->column == 0 && end == start) {
+        // Blank line
+        return true;
+    }
+    if (end - start >= 2 && pData[start] == '"' && pData[end - 1] == '"') {
+        start++;
+        end--;
+    }
+    if (end - start > INT_MAX) {
+        return false;
+    }
+    
+    if (pTable->column == pTable->columnCount && !addColumn(pTable)) {
+        return false;
+    }
+    if (!pushField(pTable, pTable->column, start, (int)(end - start))) {
+        return false;
+    }
+    pTable->column++;
+    
+    if (endsRow) {
+        for (int i = pTable->column; i < pTable->columnCount; i++) {
+            if (!pushField(pTable, i, 0, 0)) {
+                return false;
+            }
+        }
+        if (pTable->rowCount == INT_MAX) {
+            return false;
+        }
+        pTable->rowCount++;
+        pTable->column = 0;
+    }
+    
+    return true;
+}
+
+// Find the fields 64 bytes at a time, quotes are paired by a prefix XOR of their positions
+static bool tokenize(CSVTable *pTable, char separator) {
+    const char *pData = pTable->pData;
+    long long length = pTable->length;
+    long long fieldStart = 0;
+    // All ones while inside quotes at the end of the last block
+    uint64_t inQuotes = 0;
+    
+    for (long long base = 0; base < length; base += CSV_BLOCK_SIZE) {
+        const char *pBlock = pData + base;
+        char tail[CSV_BLOCK_SIZE];
+        if (length - base < CSV_BLOCK_SIZE) {
+            // Zero padding matches nothing, as the separator isn't '\0'
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, pBlock, (size_t)(length - base));
+            pBlock = tail;
+        }
+        
+        uint64_t quotes, ends, newLines;
+        structuralMasks(pBlock, separator, &quotes, &ends, &newLines);
+        
+        uint64_t quoted = prefixXor(quotes) ^ inQuotes;
+        inQuotes = (uint64_t)0 - (quoted >> 63);
+        ends &= ~quoted;
+        
+        while (ends) {
+            int bit = lowestBit(ends);
+            long long end = base + bit;
+            if (!addField(pTable, fieldStart, end, (newLines >> bit) & 1)) {
+                return false;
+            }
+            fieldStart = end + 1;
+            ends &= ends - 1;
+        }
+    }
+    
+    // An unclosed quote
+    if (inQuotes) {
+        return false;
+    }
+    
+    if (fieldStart < length || pTable->column > 0) {
+        return addField(pTable, fieldStart, length, true);
+    }
+    
+    return true;
+}
+
+// Whether the field was quoted and holds "" to unescape
+static bool hasEscapes(const CSVTable *pTable, long long offset, int length) {
+    return offset > 0 && pTable->pData[offset - 1] == '"' && length > 0 && memchr(pTable->pData + offset, '"', length);
+}
+
+// Copy the field to pOut with "" turned into '"', return the count of bytes written
+static int unescape(const char *pField, int length, char *pOut) {
+    int count = 0;
+    for (int i = 0; i < length; i++) {
+        pOut[count++] = pField[i];
+        if (pField[i] == '"' && i + 1 < length && pField[i + 1] == '"') {
+            i++;
+        }
+    }
+    
+    return count;
+}
+
+static bool fieldAt(const CSVTable *pTable, int row, int column, long long *pOffset, int *pLength) {
+    if (!pTable || column < 0 || column >= pTable->columnCount || row < 0 || row >= pTable->rowCount) {
+        return false;
+    }
+    
+    *pOffset = ((long long *)pTable->ppOffsets[column]->pData)[row];
+    *pLength = ((int *)pTable->ppLengths[column]->pData)[row];
+    
+    return true;
+}
+
+#pragma mark - Make Table
+
+// No copy, pData should stay unchanged until the table is destroyed
+// The separator can't be '"', '\r', '\n' or '\0', return NULL if the text is malformed or memory is not enough
+CSVTable *CSVTableInit(const char *pData, long long length, char separator) {
+    if ((!pData && length > 0) || length < 0 || separator == '"' || separator == '\r' || separator == '\n' || separator == '\0') {
+        return NULL;
+    }
+    
+    CSVTable *pTable = malloc(sizeof(CSVTable));
+    if (!pTable) {
+        return NULL;
+    }
+    
+    pTable->pStr = NULL;
+    pTable->pData = pData;
+    pTable->length = length;
+    pTable->rowCount = 0;
+    pTable->columnCount = 0;
+    pTable->columnCapacity = 0;
+    pTable->ppOffsets = NULL;
+    pTable->ppLengths = NULL;
+    pTable->column = 0;
+    
+    if (!tokenize(pTable, separator)) {
+        CSVTableDestroy(pTable);
+        return NULL;
+    }
+    
+    return pTable;
+}
+
+// O(1) for a String that owns its buffer, the table shares it
+// The separator can't be '"', '\r', '\n' or '\0', return NULL if the text is malformed or memory is not enough
+CSVTable *CSVTableInitWithString(const String *pStr, char separator) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    // Changes to pStr copy its buffer first, so the shared text stays the same
+    String *pCopy = StringCopy(pStr);
+    if (!pCopy) {
+        return NULL;
+    }
+    
+    CSVTable *pTable = CSVTableInit(pCopy->pData, pCopy->length, separator);
+    if (!pTable) {
+        StringDestroy(pCopy);
+        return NULL;
+    }
+    pTable->pStr = pCopy;
+    
+    return pTable;
+}
+
+void CSVTableDestroy(CSVTable *pTable) {
+    if (!pTable) {
+        return;
+    }
+    
+    for (int i = 0; i < pTable->columnCount; i++) {
+        ArrayDestroy(pTable->ppOffsets[i]);
+        ArrayDestroy(pTable->ppLengths[i]);
+    }
+    free(pTable->ppOffsets);
+    free(pTable->ppLengths);
+    StringDestroy(pTable->pStr);
+    free(pTable);
+}
+
+#pragma mark - Get Properties
+
+int CSVTableRowCount(const CSVTable *pTable) {
+    return pTable ? pTable->rowCount : 0;
+}
+
+int CSVTableColumnCount(const CSVTable *pTable) {
+    return pTable ? pTable->columnCount : 0;
+}
+
+// Array of long long, where the field of each row starts in the text, quotes excluded
+// Valid until the table is destroyed, don't modify or destroy it
+const Array *CSVTableColumnOffsets(const CSVTable *pTable, int column) {
+    if (!pTable || column < 0 || column >= pTable->columnCount) {
+        return NULL;
+    }
+    
+    return pTable->ppOffsets[column];
+}
+
+// Array of int, the length of the field of each row, quotes excluded, "" counts as two
+// Valid until the table is destroyed, don't modify or destroy it
+const Array *CSVTableColumnLengths(const CSVTable *pTable, int column) {
+    if (!pTable || column < 0 || column >= pTable->columnCount) {
+        return NULL;
+    }
+    
+    return pTable->ppLengths[column];
+}
+
+#pragma mark - Get Fields
+
+// Return a new string with "" turned into '"', return NULL if parameters invalid
+String *CSVTableField(const CSVTable *pTable, int row, int column) {
+    long long offset;
+    int length;
+    if (!fieldAt(pTable, row, column, &offset, &length)) {
+        return NULL;
+    }
+    
+    String *pField = StringInitWithBytes(pTable->pData + offset, length);
+    if (pField && hasEscapes(pTable, offset, length)) {
+        pField->length = unescape(pField->pData, length, pField->pData);
+    }
+    
+    return pField;
+}
+
+// Return Array of String with "" turned into '"', return NULL if memory is not enough, you should destroy the strings and the array by yourself
+// Fields without "" are views of the text, valid until the table is destroyed, changing one copies it first
+Array *CSVTableStringColumn(const CSVTable *pTable, int column) {
+    if (!pTable || column < 0 || column >= pTable->columnCount) {
+        return NULL;
+    }
+    
+    int count = pTable->rowCount;
+    const long long *pOffsets = pTable->ppOffsets[column]->pData;
+    const int *pLengths = pTable->ppLengths[column]->pData;
+    
+    Array *pOut = ArrayInit(sizeof(String *));
+    if (!pOut || !ArrayReserve(pOut, count)) {
+        ArrayDestroy(pOut);
+        return NULL;
+    }
+    
+    String **ppFields = pOut->pData;
+    for (int i = 0; i < count; i++) {
+        const char *pField = pTable->pData + pOffsets[i];
+        int length = pLengths[i];
+        bool escaped = hasEscapes(pTable, pOffsets[i], length);
+        
+        // An unescaped field needs only the header, an escaped one gets its characters and a '\0' after it
+        String *pStr = malloc(sizeof(String) + (escaped ? length + 1 : 0));
+        if (!pStr) {
+            for (int j = 0; j < i; j++) {
+                free(ppFields[j]);
+            }
+            ArrayDestroy(pOut);
+            return NULL;
+        }
+        
+        if (escaped) {
+            char *pBytes = (char *)(pStr + 1);
+            length = unescape(pField, length, pBytes);
+            pBytes[length] = '\0';
+            pStr->pData = pBytes;
+            // The '\0' after the field counts as capacity, see StringCStringView
+            pStr->capacity = length + 1;
+        } else {
+            pStr->pData = (char *)pField;
+            // No spare byte, so StringCStringView copies the field instead of writing to the text
+            pStr->capacity = length;
+        }
+        pStr->length = length;
+        pStr->itemSize = sizeof(char);
+        // Borrowed, the first change moves the characters to a buffer of their own
+        pStr->pBuffer = NULL;
+        
+        ppFields[i] = pStr;
+    }
+    pOut->length = count;
+    
+    return pOut;
+}
+
+// Return Array of int64_t, return NULL if a field is not a decimal integer in range
+Array *CSVTableInt64Column(const CSVTable *pTable, int column) {
+    if (!pTable || column < 0 || column >= pTable->columnCount) {
+        return NULL;
+    }
+    
+    int count = pTable->rowCount;
+    const long long *pOffsets = pTable->ppOffsets[column]->pData;
+    const int *pLengths = pTable->ppLengths[column]->pData;
+    
+    Array *pOut = ArrayInit(sizeof(int64_t));
+    if (!pOut || !ArrayReserve(pOut, count)) {
+        ArrayDestroy(pOut);
+        return NULL;
+    }
+    
+    int64_t *pValues = pOut->pData;
+    for (int i = 0; i < count; i++) {
+        if (!StringBytesToInt64(pTable->pData + pOffsets[i], pLengths[i], &pValues[i])) {
+            ArrayDestroy(pOut);
+            return NULL;
+        }
+    }
+    pOut->length = count;
+    
+    return pOut;
+}
+
+// Return Array of double, return NULL if a field is not a number
+Array *CSVTableDoubleColumn(const CSVTable *pTable, int column) {
+    if (!pTable || column < 0 || column >= pTable->columnCount) {
+        return NULL;
+    }
+    
+    int count = pTable->rowCount;
+    const long long *pOffsets = pTable->ppOffsets[column]->pData;
+    const int *pLengths = pTable->ppLengths[column]->pData;
+    
+    Array *pOut = ArrayInit(sizeof(double));
+    if (!pOut || !ArrayReserve(pOut, count)) {
+        ArrayDestroy(pOut);
+        return NULL;
+    }
+    
+    double *pValues = pOut->pData;
+    for (int i = 0; i < count; i++) {
+        if (!StringBytesToDouble(pTable->pData + pOffsets[i], pLengths[i], &pValues[i])) {
+            ArrayDestroy(pOut);
+            return NULL;
+        }
+    }
+    pOut->length = count;
+    
+    return pOut;
+}
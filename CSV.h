@@ -0,0 +1,55 @@
+//
+//  CSV.h
+//  DataStructure
+//
+
+#ifndef __CSV__
+#define __CSV__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "String.h"
+
+// Splits comma, tab or otherwise delimited text into rows and columns in one pass,
+// finding quotes, separators and new lines 64 bytes at a time.
+// Fields may be quoted with '"', a quoted field may hold separators, new lines and "" for a quote.
+// Rows end with "\n" or "\r\n", blank lines are skipped, missing fields of short rows are empty.
+
+#pragma mark - Type Definition
+
+typedef struct _csv_table CSVTable;
+
+#pragma mark - Make Table
+
+// No copy, pData should stay unchanged until the table is destroyed
+// The separator can't be '"', '\r', '\n' or '\0', return NULL if the text is malformed or memory is not enough
+CSVTable *CSVTableInit(const char *pData, long long length, char separator);
+// O(1) for a String that owns its buffer, the table shares it
+// The separator can't be '"', '\r', '\n' or '\0', return NULL if the text is malformed or memory is not enough
+CSVTable *CSVTableInitWithString(const String *pStr, char separator);
+void CSVTableDestroy(CSVTable *pTable);
+
+#pragma mark - Get Properties
+
+int CSVTableRowCount(const CSVTable *pTable);
+int CSVTableColumnCount(const CSVTable *pTable);
+// Array of long long, where the field of each row starts in the text, quotes excluded
+// Valid until the table is destroyed, don't modify or destroy it
+const Array *CSVTableColumnOffsets(const CSVTable *pTable, int column);
+// Array of int, the length of the field of each row, quotes excluded, "" counts as two
+// Valid until the table is destroyed, don't modify or destroy it
+const Array *CSVTableColumnLengths(const CSVTable *pTable, int column);
+
+#pragma mark - Get Fields
+
+// Return a new string with "" turned into '"', return NULL if parameters invalid
+String *CSVTableField(const CSVTable *pTable, int row, int column);
+// Return Array of String with "" turned into '"', return NULL if memory is not enough, you should destroy the strings and the array by yourself
+// Fields without "" are views of the text, valid until the table is destroyed, changing one copies it first
+Array *CSVTableStringColumn(const CSVTable *pTable, int column);
+// Return Array of int64_t, return NULL if a field is not a decimal integer in range
+Array *CSVTableInt64Column(const CSVTable *pTable, int column);
+// Return Array of double, return NULL if a field is not a number
+Array *CSVTableDoubleColumn(const CSVTable *pTable, int column);
+
+#endif
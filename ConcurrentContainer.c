@@ -0,0 +1,471 @@
+//
+//  ConcurrentContainer.c
+//  DataStructure
+//
+
+#include "ConcurrentContainer.h"
+#include <stdatomic.h>
+
+#pragma mark - Node Structure
+
+typedef struct _concurrent_node {
+    _Atomic(struct _concurrent_node *) pNext;
+    // Chains the node in a retired list, pNext may still be read by other threads then
+    struct _concurrent_node *pRetiredNext;
+    // Item is stored right after the node header
+} ConcurrentNode;
+
+#pragma mark - Hazard Pointer Structure
+
+#define HAZARD_POINTERS_PER_RECORD 2
+// Scan for freeable nodes after this many are retired by one record
+#define HAZARD_SCAN_THRESHOLD 64
+
+// Taken by one thread for the duration of a single operation
+typedef struct _hazard_record {
+    atomic_bool isActive;
+    _Atomic(ConcurrentNode *) hazards[HAZARD_POINTERS_PER_RECORD];
+    // Never changes after the record is published
+    struct _hazard_record *pNext;
+    // Only touched by the thread holding the record
+    ConcurrentNode *pRetired;
+    int retiredCount;
+} HazardRecord;
+
+typedef struct _hazard_domain {
+    _Atomic(HazardRecord *) pRecords;
+    atomic_int recordCount;
+} HazardDomain;
+
+#pragma mark - Container Structure
+
+struct _concurrent_stack {
+    _Atomic(ConcurrentNode *) pTop;
+    int itemSize;
+    HazardDomain domain;
+};
+
+struct _concurrent_queue {
+    // pHead is always a dummy node, the first item is in pHead->pNext
+    _Atomic(ConcurrentNode *) pHead;
+    _Atomic(ConcurrentNode *) pTail;
+    int itemSize;
+    HazardDomain domain;
+};
+
+#pragma mark - Inner Function
+
+static void *ccItemOf(ConcurrentNode *pNode) {
+    return (void *)(pNode + 1);
+}
+
+static ConcurrentNode *ccNodeInit(int itemSize, const void *pIn) {
+    ConcurrentNode *pNode = malloc(sizeof(ConcurrentNode) + itemSize);
+    if (!pNode) {
+        return NULL;
+    }
+    
+    atomic_init(&pNode->pNext, NULL);
+    pNode->pRetiredNext = NULL;
+    if (pIn) {
+        memcpy(ccItemOf(pNode), pIn, itemSize);
+    }
+    
+    return pNode;
+}
+
+static void hazardDomainInit(HazardDomain *pDomain) {
+    atomic_init(&pDomain->pRecords, NULL);
+    atomic_init(&pDomain->recordCount, 0);
+}
+
+// Free all records and the nodes retired by them, no thread should be using the domain
+static void hazardDomainDestroy(HazardDomain *pDomain) {
+    HazardRecord *pRecord = atomic_load(&pDomain->pRecords);
+    while (pRecord) {
+        HazardRecord *pNext = pRecord->pNext;
+        ConcurrentNode *pNode = pRecord->pRetired;
+        while (pNode) {
+            ConcurrentNode *pRetiredNext = pNode->pRetiredNext;
+            free(pNode);
+            pNode = pRetiredNext;
+        }
+        free(pRecord);
+        pRecord = pNext;
+    }
+    atomic_store(&pDomain->pRecords, NULL);
+}
+
+// Return NULL if memory is not enough
+static HazardRecord *hazardAcquire(HazardDomain *pDomain) {
+    // Reuse an idle record if any
+    for (HazardRecord *pRecord = atomic_load(&pDomain->pRecords); pRecord; pRecord = pRecord->pNext) {
+        bool expected = false;
+        if (!atomic_load(&pRecord->isActive) &&
+            atomic_compare_exchange_strong(&pRecord->isActive, &expected, true)) {
+            return pRecord;
+        }
+    }
+    
+    HazardRecord *pRecord = malloc(sizeof(HazardRecord));
+    if (!pRecord) {
+        return NULL;
+    }
+    
+    atomic_init(&pRecord->isActive, true);
+    for (int i = 0; i < HAZARD_POINTERS_PER_RECORD; i++) {
+        atomic_init(&pRecord->hazards[i], NULL);
+    }
+    pRecord->pRetired = NULL;
+    pRecord->retiredCount = 0;
+    
+    atomic_fetch_add(&pDomain->recordCount, 1);
+    HazardRecord *pHead = atomic_load(&pDomain->pRecords);
+    do {
+        pRecord->pNext = pHead;
+    } while (!atomic_compare_exchange_weak(&pDomain->pRecords, &pHead, pRecord));
+    
+    return pRecord;
+}
+
+static void hazardRelease(HazardRecord *pRecord) {
+    for (int i = 0; i < HAZARD_POINTERS_PER_RECORD; i++) {
+        atomic_store(&pRecord->hazards[i], NULL);
+    }
+    atomic_store(&pRecord->isActive, false);
+}
+
+// Free the retired nodes no thread is pointing to
+static void hazardScan(HazardDomain *pDomain, HazardRecord *pRecord) {
+    int capacity = atomic_load(&pDomain->recordCount) * HAZARD_POINTERS_PER_RECORD;
+    ConcurrentNode **ppHazards = malloc(capacity * sizeof(ConcurrentNode *));
+    if (!ppHazards) {
+        return; // Try again on next retire
+    }
+    
+    // Records added since the count was read come first in the list, so grow rather than skip any hazard
+    int hazardCount = 0;
+    for (HazardRecord *pCurr = atomic_load(&pDomain->pRecords); pCurr; pCurr = pCurr->pNext) {
+        for (int i = 0; i < HAZARD_POINTERS_PER_RECORD; i++) {
+            ConcurrentNode *pHazard = atomic_load(&pCurr->hazards[i]);
+            if (!pHazard) {
+                continue;
+            }
+            
+            if (hazardCount == capacity) {
+                capacity *= 2;
+                ConcurrentNode **ppNewHazards = realloc(ppHazards, capacity * sizeof(ConcurrentNode *));
+                if (!ppNewHazards) {
+                    free(ppHazards);
+                    return; // Try again on next retire
+                }
+                ppHazards = ppNewHazards;
+            }
+            ppHazards[hazardCount++] = pHazard;
+        }
+    }
+    
+    ConcurrentNode *pKept = NULL;
+    int keptCount = 0;
+    ConcurrentNode *pNode = pRecord->pRetired;
+    while (pNode) {
+        ConcurrentNode *pRetiredNext = pNode->pRetiredNext;
+        bool isHazard = false;
+        for (int i = 0; i < hazardCount; i++) {
+            if (ppHazards[i] == pNode) {
+                isHazard = true;
+                break;
+            }
+        }
+        if (isHazard) {
+            pNode->pRetiredNext = pKept;
+            pKept = pNode;
+            keptCount++;
+        } else {
+            free(pNode);
+        }
+        pNode = pRetiredNext;
+    }
+    
+    pRecord->pRetired = pKept;
+    pRecord->retiredCount = keptCount;
+    free(ppHazards);
+}
+
+static void hazardRetire(HazardDomain *pDomain, HazardRecord *pRecord, ConcurrentNode *pNode) {
+    pNode->pRetiredNext = pRecord->pRetired;
+    pRecord->pRetired = pNode;
+    pRecord->retiredCount++;
+    
+    if (pRecord->retiredCount >= HAZARD_SCAN_THRESHOLD) {
+        hazardScan(pDomain, pRecord);
+    }
+}
+
+// Load *ppSource and publish it as a hazard, return the pointer once it is stable
+static ConcurrentNode *hazardProtect(HazardRecord *pRecord, int slot, _Atomic(ConcurrentNode *) *ppSource) {
+    ConcurrentNode *pNode = atomic_load(ppSource);
+    for (;;) {
+        atomic_store(&pRecord->hazards[slot], pNode);
+        ConcurrentNode *pCheck = atomic_load(ppSource);
+        if (pCheck == pNode) {
+            return pNode;
+        }
+        pNode = pCheck;
+    }
+}
+
+#pragma mark - Concurrent Stack
+
+ConcurrentStack *ConcurrentStackInit(int itemSize) {
+    if (itemSize <= 0) {
+        return NULL;
+    }
+    
+    ConcurrentStack *pStack = malloc(sizeof(ConcurrentStack));
+    if (!pStack) {
+        return NULL;
+    }
+    
+    atomic_init(&pStack->pTop, NULL);
+    pStack->itemSize = itemSize;
+    hazardDomainInit(&pStack->domain);
+    
+    return pStack;
+}
+
+// No other thread should be using the stack
+void ConcurrentStackDestroy(ConcurrentStack *pStack) {
+    if (!pStack) {
+        return;
+    }
+    
+    ConcurrentNode *pNode = atomic_load(&pStack->pTop);
+    while (pNode) {
+        ConcurrentNode *pNext = atomic_load(&pNode->pNext);
+        free(pNode);
+        pNode = pNext;
+    }
+    
+    hazardDomainDestroy(&pStack->domain);
+    free(pStack);
+}
+
+int ConcurrentStackItemSize(const ConcurrentStack *pStack) {
+    return pStack ? pStack->itemSize : -1;
+}
+
+bool ConcurrentStackIsEmpty(const ConcurrentStack *pStack) {
+    if (!pStack) {
+        return true;
+    }
+    
+    return atomic_load(&((ConcurrentStack *)pStack)->pTop) == NULL;
+}
+
+bool ConcurrentStackPush(ConcurrentStack *pStack, const void *pIn) {
+    if (!pStack || !pIn) {
+        return false;
+    }
+    
+    ConcurrentNode *pNode = ccNodeInit(pStack->itemSize, pIn);
+    if (!pNode) {
+        return false;
+    }
+    
+    ConcurrentNode *pTop = atomic_load(&pStack->pTop);
+    do {
+        atomic_store(&pNode->pNext, pTop);
+    } while (!atomic_compare_exchange_weak(&pStack->pTop, &pTop, pNode));
+    
+    return true;
+}
+
+// Return false if the stack is empty
+bool ConcurrentStackPop(ConcurrentStack *pStack, void *pOut) {
+    if (!pStack || !pOut) {
+        return false;
+    }
+    
+    HazardRecord *pRecord = hazardAcquire(&pStack->domain);
+    if (!pRecord) {
+        return false;
+    }
+    
+    ConcurrentNode *pTop = NULL;
+    for (;;) {
+        pTop = hazardProtect(pRecord, 0, &pStack->pTop);
+        if (!pTop) {
+            hazardRelease(pRecord);
+            return false;
+        }
+        
+        // pTop can't be freed while it is a hazard, so neither reading it nor the CAS suffers from ABA
+        ConcurrentNode *pNext = atomic_load(&pTop->pNext);
+        if (atomic_compare_exchange_strong(&pStack->pTop, &pTop, pNext)) {
+            break;
+        }
+    }
+    
+    memcpy(pOut, ccItemOf(pTop), pStack->itemSize);
+    
+    atomic_store(&pRecord->hazards[0], NULL);
+    hazardRetire(&pStack->domain, pRecord, pTop);
+    hazardRelease(pRecord);
+    
+    return true;
+}
+
+#pragma mark - Concurrent Queue
+
+ConcurrentQueue *ConcurrentQueueInit(int itemSize) {
+    if (itemSize <= 0) {
+        return NULL;
+    }
+    
+    ConcurrentQueue *pQueue = malloc(sizeof(ConcurrentQueue));
+    if (!pQueue) {
+        return NULL;
+    }
+    
+    ConcurrentNode *pDummy = ccNodeInit(itemSize, NULL);
+    if (!pDummy) {
+        free(pQueue);
+        return NULL;
+    }
+    
+    atomic_init(&pQueue->pHead, pDummy);
+    atomic_init(&pQueue->pTail, pDummy);
+    pQueue->itemSize = itemSize;
+    hazardDomainInit(&pQueue->domain);
+    
+    return pQueue;
+}
+
+// No other thread should be using the queue
+void ConcurrentQueueDestroy(ConcurrentQueue *pQueue) {
+    if (!pQueue) {
+        return;
+    }
+    
+    ConcurrentNode *pNode = atomic_load(&pQueue->pHead);
+    while (pNode) {
+        ConcurrentNode *pNext = atomic_load(&pNode->pNext);
+        free(pNode);
+        pNode = pNext;
+    }
+    
+    hazardDomainDestroy(&pQueue->domain);
+    free(pQueue);
+}
+
+int ConcurrentQueueItemSize(const ConcurrentQueue *pQueue) {
+    return pQueue ? pQueue->itemSize : -1;
+}
+
+bool ConcurrentQueueIsEmpty(const ConcurrentQueue *pQueue) {
+    if (!pQueue) {
+        return true;
+    }
+    
+    // The dummy head is never freed while the queue is alive if it has no successor
+    ConcurrentQueue *pMutableQueue = (ConcurrentQueue *)pQueue;
+    HazardRecord *pRecord = hazardAcquire(&pMutableQueue->domain);
+    if (!pRecord) {
+        return false;
+    }
+    
+    ConcurrentNode *pHead = hazardProtect(pRecord, 0, &pMutableQueue->pHead);
+    bool isEmpty = atomic_load(&pHead->pNext) == NULL;
+    hazardRelease(pRecord);
+    
+    return isEmpty;
+}
+
+bool ConcurrentQueueEnqueue(ConcurrentQueue *pQueue, const void *pIn) {
+    if (!pQueue || !pIn) {
+        return false;
+    }
+    
+    ConcurrentNode *pNode = ccNodeInit(pQueue->itemSize, pIn);
+    if (!pNode) {
+        return false;
+    }
+    
+    HazardRecord *pRecord = hazardAcquire(&pQueue->domain);
+    if (!pRecord) {
+        free(pNode);
+        return false;
+    }
+    
+    ConcurrentNode *pTail = NULL;
+    for (;;) {
+        pTail = hazardProtect(pRecord, 0, &pQueue->pTail);
+        ConcurrentNode *pNext = atomic_load(&pTail->pNext);
+        if (pTail != atomic_load(&pQueue->pTail)) {
+            continue;
+        }
+        
+        if (pNext) {
+            // Tail is lagging behind, help moving it forward
+            atomic_compare_exchange_strong(&pQueue->pTail, &pTail, pNext);
+            continue;
+        }
+        
+        ConcurrentNode *pExpected = NULL;
+        if (atomic_compare_exchange_strong(&pTail->pNext, &pExpected, pNode)) {
+            break;
+        }
+    }
+    
+    atomic_compare_exchange_strong(&pQueue->pTail, &pTail, pNode);
+    hazardRelease(pRecord);
+    
+    return true;
+}
+
+// Return false if the queue is empty
+bool ConcurrentQueueDequeue(ConcurrentQueue *pQueue, void *pOut) {
+    if (!pQueue || !pOut) {
+        return false;
+    }
+    
+    HazardRecord *pRecord = hazardAcquire(&pQueue->domain);
+    if (!pRecord) {
+        return false;
+    }
+    
+    ConcurrentNode *pHead = NULL;
+    for (;;) {
+        pHead = hazardProtect(pRecord, 0, &pQueue->pHead);
+        ConcurrentNode *pTail = atomic_load(&pQueue->pTail);
+        ConcurrentNode *pNext = hazardProtect(pRecord, 1, &pHead->pNext);
+        if (pHead != atomic_load(&pQueue->pHead)) {
+            continue;
+        }
+        
+        if (!pNext) {
+            hazardRelease(pRecord);
+            return false;
+        }
+        
+        if (pHead == pTail) {
+            // Tail is lagging behind, help moving it forward
+            atomic_compare_exchange_strong(&pQueue->pTail, &pTail, pNext);
+            continue;
+        }
+        
+        // Copy before the CAS, pNext becomes the new dummy and may be dequeued right after
+        memcpy(pOut, ccItemOf(pNext), pQueue->itemSize);
+        if (atomic_compare_exchange_strong(&pQueue->pHead, &pHead, pNext)) {
+            break;
+        }
+    }
+    
+    atomic_store(&pRecord->hazards[0], NULL);
+    atomic_store(&pRecord->hazards[1], NULL);
+    hazardRetire(&pQueue->domain, pRecord, pHead);
+    hazardRelease(pRecord);
+    
+    return true;
+}
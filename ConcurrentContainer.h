@@ -0,0 +1,46 @@
+//
+//  ConcurrentContainer.h
+//  DataStructure
+//
+
+#ifndef __ConcurrentContainer__
+#define __ConcurrentContainer__
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Lock-free containers built on C11 atomics, removed nodes are freed through hazard pointers.
+// All functions except Init and Destroy can be called from any thread at the same time.
+
+#pragma mark - Type Definition
+
+// Treiber stack
+typedef struct _concurrent_stack ConcurrentStack;
+// Michael-Scott queue
+typedef struct _concurrent_queue ConcurrentQueue;
+
+#pragma mark - Concurrent Stack
+
+ConcurrentStack *ConcurrentStackInit(int itemSize);
+// No other thread should be using the stack
+void ConcurrentStackDestroy(ConcurrentStack *pStack);
+int  ConcurrentStackItemSize(const ConcurrentStack *pStack);
+bool ConcurrentStackIsEmpty(const ConcurrentStack *pStack);
+bool ConcurrentStackPush(ConcurrentStack *pStack, const void *pIn);
+// Return false if the stack is empty
+bool ConcurrentStackPop(ConcurrentStack *pStack, void *pOut);
+
+#pragma mark - Concurrent Queue
+
+ConcurrentQueue *ConcurrentQueueInit(int itemSize);
+// No other thread should be using the queue
+void ConcurrentQueueDestroy(ConcurrentQueue *pQueue);
+int  ConcurrentQueueItemSize(const ConcurrentQueue *pQueue);
+bool ConcurrentQueueIsEmpty(const ConcurrentQueue *pQueue);
+bool ConcurrentQueueEnqueue(ConcurrentQueue *pQueue, const void *pIn);
+// Return false if the queue is empty
+bool ConcurrentQueueDequeue(ConcurrentQueue *pQueue, void *pOut);
+
+#endif
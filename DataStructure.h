@@ -11,6 +11,18 @@
 
 #include "DynamicArray.h"
 #include "LinkedList.h"
+#include "IntrusiveList.h"
+#include "SkipList.h"
+#include "ConcurrentContainer.h"
 #include "String.h"
+#include "StringSearch.h"
+#include "StringPool.h"
+#include "Rope.h"
+#include "StringBuilder.h"
+#include "MultiPatternMatcher.h"
+#include "StringReader.h"
+#include "CSV.h"
+#include "RabinKarp.h"
+#include "StringIndex.h"
 
 #endif
@@ -7,6 +7,8 @@
 //
 
 #include "DynamicArray.h"
+#include <limits.h>
+#include <stdatomic.h>
 
 #pragma mark - Dynamic Array Structure
 
@@ -14,14 +16,99 @@ struct _dynamic_array {
     void *pData;
     int length;
     int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
 };
 
+#pragma mark - Shared Buffer Structure
+
+// Copies share one buffer until one of them changes, then that one gets its own
+typedef struct _array_buffer {
+    atomic_int refCount;
+} ArrayBuffer;
+
+// Items start this far into the buffer, so they are aligned for any type
+#define ARRAY_BUFFER_HEADER_SIZE 16
+
 #pragma mark - Inner Function
 
 static void *itemAt(const Array *pArr, int index) {
     return (void *)((char *)(pArr->pData) + index * pArr->itemSize);
 }
 
+static char *bufferItems(ArrayBuffer *pBuffer) {
+    return (char *)pBuffer + ARRAY_BUFFER_HEADER_SIZE;
+}
+
+static ArrayBuffer *bufferInit(size_t size) {
+    ArrayBuffer *pBuffer = malloc(ARRAY_BUFFER_HEADER_SIZE + size);
+    if (!pBuffer) {
+        return NULL;
+    }
+    
+    atomic_init(&pBuffer->refCount, 1);
+    
+    return pBuffer;
+}
+
+static void bufferRelease(ArrayBuffer *pBuffer) {
+    if (pBuffer && atomic_fetch_sub_explicit(&pBuffer->refCount, 1, memory_order_acq_rel) == 1) {
+        free(pBuffer);
+    }
+}
+
+// Whether the items can be written without other arrays seeing it
+static bool isUnique(const Array *pArr) {
+    if (!pArr->pData) {
+        return true;
+    }
+    
+    return pArr->pBuffer && atomic_load_explicit(&pArr->pBuffer->refCount, memory_order_acquire) == 1;
+}
+
+// Move the items to a new buffer of its own with room for capacity items
+static bool detach(Array *pArr, int capacity) {
+    if (capacity < pArr->length) {
+        capacity = pArr->length;
+    }
+    
+    ArrayBuffer *pBuffer = bufferInit((size_t)capacity * pArr->itemSize);
+    if (!pBuffer) {
+        return false;
+    }
+    
+    if (pArr->length > 0) {
+        memcpy(bufferItems(pBuffer), pArr->pData, (size_t)pArr->length * pArr->itemSize);
+    }
+    bufferRelease(pArr->pBuffer);
+    
+    pArr->pBuffer = pBuffer;
+    pArr->pData = bufferItems(pBuffer);
+    pArr->capacity = capacity;
+    
+    return true;
+}
+
+// Call before writing items in place
+static bool makeUnique(Array *pArr) {
+    return isUnique(pArr) || detach(pArr, pArr->capacity);
+}
+
+// Grow geometrically, so appending one by one costs amortized O(1)
+static bool growTo(Array *pArr, int minCapacity) {
+    if (minCapacity <= pArr->capacity) {
+        return makeUnique(pArr);
+    }
+    
+    int capacity = pArr->capacity < 4 ? 4 : pArr->capacity;
+    while (capacity < minCapacity) {
+        capacity = capacity > INT_MAX / 2 ? minCapacity : capacity * 2;
+    }
+    
+    return ArrayReserve(pArr, capacity);
+}
+
 #pragma mark - Make Array
 
 Array *ArrayInit(int itemSize) {
@@ -37,6 +124,8 @@ Array *ArrayInit(int itemSize) {
     pArr->pData = NULL;
     pArr->itemSize = itemSize;
     pArr->length = 0;
+    pArr->capacity = 0;
+    pArr->pBuffer = NULL;
     
     return pArr;
 }
@@ -51,39 +140,61 @@ Array *ArrayInitWithLength(int itemSize, int initLen) {
         return NULL;
     }
     
-    pArr->pData = calloc(initLen, itemSize);
-    if (!pArr->pData) {
-        free(pArr);
+    if (!ArrayReserve(pArr, initLen)) {
+        ArrayDestroy(pArr);
         return NULL;
     }
     
+    if (initLen > 0) {
+        memset(pArr->pData, 0, (size_t)initLen * itemSize);
+    }
     pArr->length = initLen;
     
     return pArr;
 }
 
+// O(1), shares the items with pArr until either of them changes
 Array *ArraySubArray(const Array *pArr, int start, int length) {
     if (!pArr) {
         return NULL;
     }
     
-    if (start < 0 || length < 0 || start + length > pArr->length) {
+    if (start < 0 || length < 0 || start > pArr->length - length) {
         return NULL;
     }
     
-    Array *pOut = ArrayInitWithLength(pArr->itemSize, length);
-    if (!pOut) {
-        return NULL;
+    Array *pOut = ArrayInit(pArr->itemSize);
+    if (!pOut || length == 0) {
+        return pOut;
     }
     
-    for (int i = 0; i < length; i++) {
-        ArraySetItem(pOut, i, itemAt(pArr, start + i));
+    if (!pArr->pBuffer) {
+        // Borrowed items may go away with their owner, so copy them
+        if (!ArrayReserve(pOut, length)) {
+            ArrayDestroy(pOut);
+            return NULL;
+        }
+        memcpy(pOut->pData, itemAt(pArr, start), (size_t)length * pArr->itemSize);
+        pOut->length = length;
+        return pOut;
     }
     
+    atomic_fetch_add_explicit(&pArr->pBuffer->refCount, 1, memory_order_relaxed);
+    pOut->pBuffer = pArr->pBuffer;
+    pOut->pData = itemAt(pArr, start);
+    pOut->length = length;
+    // Growing has to copy anyway
+    pOut->capacity = length;
+    
     return pOut;
 }
 
+// O(1), shares the items with pArr until either of them changes
 Array *ArrayCopy(const Array *pArr) {
+    if (!pArr) {
+        return NULL;
+    }
+    
     return ArraySubArray(pArr, 0, pArr->length);
 }
 
@@ -118,6 +229,10 @@ int ArrayItemSize(const Array *pArr) {
     return pArr ? pArr->itemSize : -1;
 }
 
+int ArrayCapacity(const Array *pArr) {
+    return pArr ? pArr->capacity : -1;
+}
+
 #pragma mark - Manipulate Whole Array
 
 void ArrayDestroy(Array *pArr) {
@@ -125,10 +240,7 @@ void ArrayDestroy(Array *pArr) {
         return;
     }
     
-    if (pArr->pData) {
-        free(pArr->pData);
-        pArr->pData = NULL;
-    }
+    bufferRelease(pArr->pBuffer);
     free(pArr);
 }
 
@@ -137,15 +249,49 @@ void ArrayClear(Array *pArr) {
         return;
     }
     
-    if (pArr->pData) {
-        free(pArr->pData);
-        pArr->pData = NULL;
-    }
+    bufferRelease(pArr->pBuffer);
+    pArr->pBuffer = NULL;
+    pArr->pData = NULL;
     pArr->length = 0;
+    pArr->capacity = 0;
+}
+
+// Make room for at least capacity items, the length is not changed
+// A shared buffer is copied first, so call it before writing to pData directly
+bool ArrayReserve(Array *pArr, int capacity) {
+    if (!pArr || capacity < 0) {
+        return false;
+    }
+    
+    if (capacity < pArr->capacity) {
+        capacity = pArr->capacity;
+    }
+    
+    if (isUnique(pArr)) {
+        if (capacity == pArr->capacity) {
+            return true;
+        }
+        
+        if (pArr->pBuffer && pArr->pData == bufferItems(pArr->pBuffer)) {
+            ArrayBuffer *pBuffer = realloc(pArr->pBuffer, ARRAY_BUFFER_HEADER_SIZE + (size_t)capacity * pArr->itemSize);
+            if (!pBuffer) {
+                return false;
+            }
+            
+            pArr->pBuffer = pBuffer;
+            pArr->pData = bufferItems(pBuffer);
+            pArr->capacity = capacity;
+            
+            return true;
+        }
+    }
+    
+    return detach(pArr, capacity);
 }
 
+// pFunc may change the items, so a shared buffer is copied first, nothing is traversed if memory is not enough
 void ArrayTraverse(Array *pArr, void (*pFunc)(void *)) {
-    if (!pArr || !pFunc) {
+    if (!pArr || !pFunc || !makeUnique(pArr)) {
         return;
     }
     
@@ -249,6 +395,10 @@ bool ArraySetItem(Array *pArr, int index, const void *pIn) {
         return false;
     }
     
+    if (!makeUnique(pArr)) {
+        return false;
+    }
+    
     memcpy(itemAt(pArr, index), pIn, pArr->itemSize);
     
     return true;
@@ -317,12 +467,10 @@ bool ArrayAppendItem(Array *pArr, const void *pIn) {
         return false;
     }
     
-    void *pData = realloc(pArr->pData, (pArr->length + 1) * pArr->itemSize);
-    if (!pData) {
+    if (!growTo(pArr, pArr->length + 1)) {
         return false;
     }
     
-    pArr->pData = pData;
     pArr->length++;
     ArraySetItem(pArr, pArr->length - 1, pIn);
     
@@ -339,17 +487,19 @@ bool ArrayAppendArray(Array *pArr, const Array *pNewArr) {
 		return false;
 	}
     
-    void *pData = realloc(pArr->pData, (pArr->length + pNewArr->length) * pArr->itemSize);
-    if (!pData) {
+    int newLen = pNewArr->length; // pNewArr may be pArr itself
+    if (newLen == 0) {
+        return true;
+    }
+    
+    if (!growTo(pArr, pArr->length + newLen)) {
         return false;
     }
     
-    pArr->pData = pData;
-    int originLen = pArr->length;
-    pArr->length += pNewArr->length;
-    for (int i = 0; i < pNewArr->length; i++) {
-        ArraySetItem(pArr, originLen + i, itemAt(pNewArr, i));
+    if (newLen > 0) {
+        memcpy(itemAt(pArr, pArr->length), pNewArr->pData, newLen * pArr->itemSize);
     }
+    pArr->length += newLen;
     
     return true;
 }
@@ -376,6 +526,10 @@ bool ArrayMoveItem(Array *pArr, int oldIndex, int newIndex) { // TODO
         return true;
     }
     
+    if (!makeUnique(pArr)) {
+        return false;
+    }
+    
     void *pTemp = malloc(pArr->itemSize);
     if (!pTemp) {
         return false;
@@ -413,6 +567,10 @@ bool ArraySwapItems(Array *pArr, int aIndex, int bIndex) {
         return true;
     }
     
+    if (!makeUnique(pArr)) {
+        return false;
+    }
+    
     void *pA = itemAt(pArr, aIndex);
     void *pB = itemAt(pArr, bIndex);
     
@@ -444,6 +602,10 @@ bool ArrayReplaceItemAWithB(Array *pArr, int aIndex, int bIndex) {
         return true;
     }
     
+    if (!makeUnique(pArr)) {
+        return false;
+    }
+    
     memcpy(itemAt(pArr, aIndex), itemAt(pArr, bIndex), pArr->itemSize);
     
     return true;
@@ -458,11 +620,14 @@ bool ArrayDeleteItem(Array *pArr, int index) {
         return false;
     }
     
-    for (int i = index + 1; i < pArr->length; i++) {
-        ArrayReplaceItemAWithB(pArr, i - 1, i);
+    // Dropping the last item writes nothing, so a shared buffer can stay shared
+    if (index < pArr->length - 1) {
+        if (!makeUnique(pArr)) {
+            return false;
+        }
+        memmove(itemAt(pArr, index), itemAt(pArr, index + 1), (pArr->length - index - 1) * pArr->itemSize);
     }
     pArr->length--;
-    pArr->pData = realloc(pArr->pData, pArr->length * pArr->itemSize);
     
     return true;
 }
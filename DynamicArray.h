@@ -16,13 +16,18 @@
 
 #pragma mark - Type Definition
 
+// Copies share their items through an atomically reference counted buffer,
+// the first change to a shared array gives it its own copy
+// Items are copied as bytes, so items must not point into the array's own buffer, a copy or growth leaves them pointing at the old one
 typedef struct _dynamic_array Array;
 
 #pragma mark - Make Array
 
 Array *ArrayInit(int itemSize);
 Array *ArrayInitWithLength(int itemSize, int initLen);
+// O(1), shares the items with pArr until either of them changes
 Array *ArraySubArray(const Array *pArr, int start, int length);
+// O(1), shares the items with pArr until either of them changes
 Array *ArrayCopy(const Array *pArr);
 Array *ArrayConcat(const Array *pArrA, const Array *pArrB);
 
@@ -30,11 +35,17 @@ Array *ArrayConcat(const Array *pArrA, const Array *pArrB);
 
 int ArrayLength(const Array *pArr);
 int ArrayItemSize(const Array *pArr);
+// Count of items the array can hold before it has to grow
+int ArrayCapacity(const Array *pArr);
 
 #pragma mark - Manipulate Whole Array
 
 void ArrayDestroy(Array *pArr);
 void ArrayClear(Array *pArr);
+// Make room for at least capacity items, the length is not changed
+// A shared buffer is copied first, so call it before writing to pData directly
+bool ArrayReserve(Array *pArr, int capacity);
+// pFunc may change the items, so a shared buffer is copied first, nothing is traversed if memory is not enough
 void ArrayTraverse(Array *pArr, void (*pFunc)(void *));
 // Probably mess up the original order if memory is not enough
 bool ArraySort(Array *pArr, int (*pCompareFunc)(const void *, const void *), bool ascend);
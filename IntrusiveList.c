@@ -0,0 +1,236 @@
+//
+//  IntrusiveList.c
+//  DataStructure
+//
+
+#include "IntrusiveList.h"
+
+#pragma mark - Inner Function
+
+static void ilLink(IntrusiveLink *pPrev, IntrusiveLink *pNext, IntrusiveLink *pNewLink) {
+    pNewLink->pPrev = pPrev;
+    pNewLink->pNext = pNext;
+    pPrev->pNext = pNewLink;
+    pNext->pPrev = pNewLink;
+}
+
+static void ilUnlink(IntrusiveLink *pLink) {
+    pLink->pPrev->pNext = pLink->pNext;
+    pLink->pNext->pPrev = pLink->pPrev;
+    pLink->pPrev = NULL;
+    pLink->pNext = NULL;
+}
+
+#pragma mark - Make List
+
+// Accept list not allocated by the library (on stack or embedded)
+void IntrusiveListInit(IntrusiveList *pList) {
+    if (!pList) {
+        return;
+    }
+    
+    pList->head.pPrev = &pList->head;
+    pList->head.pNext = &pList->head;
+    pList->length = 0;
+}
+
+// Unlinked link is not in any list, should be called before the first insert
+void IntrusiveLinkInit(IntrusiveLink *pLink) {
+    if (!pLink) {
+        return;
+    }
+    
+    pLink->pPrev = NULL;
+    pLink->pNext = NULL;
+}
+
+#pragma mark - Get Properties
+
+int IntrusiveListLength(const IntrusiveList *pList) {
+    return pList ? pList->length : -1;
+}
+
+bool IntrusiveListIsEmpty(const IntrusiveList *pList) {
+    return !pList || pList->length == 0;
+}
+
+bool IntrusiveLinkIsLinked(const IntrusiveLink *pLink) {
+    return pLink && pLink->pNext;
+}
+
+#pragma mark - Manipulate Whole List
+
+// Unlink all elements, the elements themselves are left untouched
+void IntrusiveListClear(IntrusiveList *pList) {
+    if (!pList) {
+        return;
+    }
+    
+    while (pList->length > 0) {
+        IntrusiveListRemoveHead(pList);
+    }
+}
+
+void IntrusiveListTraverse(IntrusiveList *pList, void (*pFunc)(IntrusiveLink *)) {
+    if (!pList || !pFunc) {
+        return;
+    }
+    
+    // Fetch next first, so pFunc may remove the current element
+    IntrusiveLink *pLink = pList->head.pNext;
+    while (pLink != &pList->head) {
+        IntrusiveLink *pNext = pLink->pNext;
+        pFunc(pLink);
+        pLink = pNext;
+    }
+}
+
+// Move all elements of pNewList to the end of pList, O(1)
+void IntrusiveListSplice(IntrusiveList *pList, IntrusiveList *pNewList) {
+    if (!pList || !pNewList || pList == pNewList || pNewList->length == 0) {
+        return;
+    }
+    
+    IntrusiveLink *pFirst = pNewList->head.pNext;
+    IntrusiveLink *pLast = pNewList->head.pPrev;
+    
+    pFirst->pPrev = pList->head.pPrev;
+    pList->head.pPrev->pNext = pFirst;
+    pLast->pNext = &pList->head;
+    pList->head.pPrev = pLast;
+    pList->length += pNewList->length;
+    
+    IntrusiveListInit(pNewList);
+}
+
+#pragma mark - Navigate
+
+IntrusiveLink *IntrusiveListHead(const IntrusiveList *pList) {
+    if (!pList || pList->length == 0) {
+        return NULL;
+    }
+    
+    return pList->head.pNext;
+}
+
+IntrusiveLink *IntrusiveListTail(const IntrusiveList *pList) {
+    if (!pList || pList->length == 0) {
+        return NULL;
+    }
+    
+    return pList->head.pPrev;
+}
+
+IntrusiveLink *IntrusiveListNext(const IntrusiveList *pList, const IntrusiveLink *pLink) {
+    if (!pList || !pLink || pLink->pNext == &pList->head) {
+        return NULL;
+    }
+    
+    return pLink->pNext;
+}
+
+IntrusiveLink *IntrusiveListPrev(const IntrusiveList *pList, const IntrusiveLink *pLink) {
+    if (!pList || !pLink || pLink->pPrev == &pList->head) {
+        return NULL;
+    }
+    
+    return pLink->pPrev;
+}
+
+#pragma mark - Manipulate Single Element
+
+bool IntrusiveListInsertHead(IntrusiveList *pList, IntrusiveLink *pNewLink) {
+    return IntrusiveListInsertAfter(pList, pList ? &pList->head : NULL, pNewLink);
+}
+
+bool IntrusiveListInsertTail(IntrusiveList *pList, IntrusiveLink *pNewLink) {
+    return IntrusiveListInsertBefore(pList, pList ? &pList->head : NULL, pNewLink);
+}
+
+// pLink should be in pList, the new link should not be in any list
+bool IntrusiveListInsertBefore(IntrusiveList *pList, IntrusiveLink *pLink, IntrusiveLink *pNewLink) {
+    if (!pList || !pLink || !pNewLink) {
+        return false;
+    }
+    
+    if (pNewLink->pNext) {
+        return false;
+    }
+    
+    ilLink(pLink->pPrev, pLink, pNewLink);
+    pList->length++;
+    
+    return true;
+}
+
+bool IntrusiveListInsertAfter(IntrusiveList *pList, IntrusiveLink *pLink, IntrusiveLink *pNewLink) {
+    if (!pList || !pLink || !pNewLink) {
+        return false;
+    }
+    
+    if (pNewLink->pNext) {
+        return false;
+    }
+    
+    ilLink(pLink, pLink->pNext, pNewLink);
+    pList->length++;
+    
+    return true;
+}
+
+// pLink should be in pList
+bool IntrusiveListRemove(IntrusiveList *pList, IntrusiveLink *pLink) {
+    if (!pList || !pLink) {
+        return false;
+    }
+    
+    if (!pLink->pNext || pLink == &pList->head) {
+        return false;
+    }
+    
+    ilUnlink(pLink);
+    pList->length--;
+    
+    return true;
+}
+
+IntrusiveLink *IntrusiveListRemoveHead(IntrusiveList *pList) {
+    IntrusiveLink *pLink = IntrusiveListHead(pList);
+    if (pLink) {
+        IntrusiveListRemove(pList, pLink);
+    }
+    
+    return pLink;
+}
+
+IntrusiveLink *IntrusiveListRemoveTail(IntrusiveList *pList) {
+    IntrusiveLink *pLink = IntrusiveListTail(pList);
+    if (pLink) {
+        IntrusiveListRemove(pList, pLink);
+    }
+    
+    return pLink;
+}
+
+// pLink should be in pList
+bool IntrusiveListMoveToHead(IntrusiveList *pList, IntrusiveLink *pLink) {
+    if (!pList || !pLink || !pLink->pNext || pLink == &pList->head) {
+        return false;
+    }
+    
+    ilUnlink(pLink);
+    ilLink(&pList->head, pList->head.pNext, pLink);
+    
+    return true;
+}
+
+bool IntrusiveListMoveToTail(IntrusiveList *pList, IntrusiveLink *pLink) {
+    if (!pList || !pLink || !pLink->pNext || pLink == &pList->head) {
+        return false;
+    }
+    
+    ilUnlink(pLink);
+    ilLink(pList->head.pPrev, &pList->head, pLink);
+    
+    return true;
+}
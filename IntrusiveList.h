@@ -0,0 +1,79 @@
+//
+//  IntrusiveList.h
+//  DataStructure
+//
+
+#ifndef __IntrusiveList__
+#define __IntrusiveList__
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Doubly linked list of caller's own structs, which embed an IntrusiveLink.
+// The list only relinks pointers, nothing is allocated or copied.
+
+#pragma mark - Type Definition
+
+typedef struct _intrusive_link {
+    struct _intrusive_link *pPrev;
+    struct _intrusive_link *pNext;
+} IntrusiveLink;
+
+// Circular, the head link is the sentinel
+typedef struct _intrusive_list {
+    IntrusiveLink head;
+    int length;
+} IntrusiveList;
+
+// Get the struct containing the link, example: IntrusiveListEntry(pLink, struct job, link)
+#define IntrusiveListEntry(pLink, type, member) \
+    ((type *)((char *)(pLink) - offsetof(type, member)))
+
+#pragma mark - Make List
+
+// Accept list not allocated by the library (on stack or embedded)
+void IntrusiveListInit(IntrusiveList *pList);
+// Unlinked link is not in any list, should be called before the first insert
+void IntrusiveLinkInit(IntrusiveLink *pLink);
+
+#pragma mark - Get Properties
+
+int  IntrusiveListLength(const IntrusiveList *pList);
+bool IntrusiveListIsEmpty(const IntrusiveList *pList);
+bool IntrusiveLinkIsLinked(const IntrusiveLink *pLink);
+
+#pragma mark - Manipulate Whole List
+
+// Unlink all elements, the elements themselves are left untouched
+void IntrusiveListClear(IntrusiveList *pList);
+void IntrusiveListTraverse(IntrusiveList *pList, void (*pFunc)(IntrusiveLink *));
+// Move all elements of pNewList to the end of pList, O(1)
+void IntrusiveListSplice(IntrusiveList *pList, IntrusiveList *pNewList);
+
+#pragma mark - Navigate
+
+// Return NULL if no such element
+IntrusiveLink *IntrusiveListHead(const IntrusiveList *pList);
+IntrusiveLink *IntrusiveListTail(const IntrusiveList *pList);
+IntrusiveLink *IntrusiveListNext(const IntrusiveList *pList, const IntrusiveLink *pLink);
+IntrusiveLink *IntrusiveListPrev(const IntrusiveList *pList, const IntrusiveLink *pLink);
+
+#pragma mark - Manipulate Single Element
+
+// The new link should not be in any list
+bool IntrusiveListInsertHead(IntrusiveList *pList, IntrusiveLink *pNewLink);
+bool IntrusiveListInsertTail(IntrusiveList *pList, IntrusiveLink *pNewLink);
+// pLink should be in pList, the new link should not be in any list
+bool IntrusiveListInsertBefore(IntrusiveList *pList, IntrusiveLink *pLink, IntrusiveLink *pNewLink);
+bool IntrusiveListInsertAfter(IntrusiveList *pList, IntrusiveLink *pLink, IntrusiveLink *pNewLink);
+// pLink should be in pList
+bool IntrusiveListRemove(IntrusiveList *pList, IntrusiveLink *pLink);
+// Return NULL if the list is empty
+IntrusiveLink *IntrusiveListRemoveHead(IntrusiveList *pList);
+IntrusiveLink *IntrusiveListRemoveTail(IntrusiveList *pList);
+// pLink should be in pList
+bool IntrusiveListMoveToHead(IntrusiveList *pList, IntrusiveLink *pLink);
+bool IntrusiveListMoveToTail(IntrusiveList *pList, IntrusiveLink *pLink);
+
+#endif
@@ -15,11 +15,18 @@ typedef struct _singly_llist_node {
     struct _singly_llist_node *pNext;
 } SinglyLListNode;
 
+// Holds nodes and items made by bulk construction, freed with the list
+typedef struct _singly_llist_block {
+    struct _singly_llist_block *pNext;
+    size_t size;
+} SinglyLListBlock;
+
 struct _singly_llist {
     SinglyLListNode *pHead;
     SinglyLListNode *pTail;
     int itemSize;
     int length;
+    SinglyLListBlock *pBlocks;
 };
 
 #pragma mark - Inner Function
@@ -32,6 +39,63 @@ static SinglyLListNode *sllNodeAt(const SinglyLList *pList, int index) {
     return pNode;
 }
 
+static bool sllIsInBlock(const SinglyLList *pList, const void *p) {
+    for (SinglyLListBlock *pBlock = pList->pBlocks; pBlock; pBlock = pBlock->pNext) {
+        if ((const char *)p >= (const char *)pBlock && (const char *)p < (const char *)pBlock + pBlock->size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Items may be swapped between nodes, so node and item are checked separately
+static void sllFreeNode(const SinglyLList *pList, SinglyLListNode *pNode) {
+    if (!pList->pBlocks) {
+        free(pNode->pData);
+        free(pNode);
+        return;
+    }
+    
+    if (!sllIsInBlock(pList, pNode->pData)) {
+        free(pNode->pData);
+    }
+    if (!sllIsInBlock(pList, pNode)) {
+        free(pNode);
+    }
+}
+
+// Make a list of count nodes linked in order, the items are left for the caller to fill
+static SinglyLList *sllInitWithBlock(int itemSize, int count) {
+    SinglyLList *pList = SinglyLListInit(itemSize);
+    if (!pList || count <= 0) {
+        return pList;
+    }
+    
+    size_t size = sizeof(SinglyLListBlock) + (size_t)count * (sizeof(SinglyLListNode) + itemSize);
+    SinglyLListBlock *pBlock = malloc(size);
+    if (!pBlock) {
+        free(pList);
+        return NULL;
+    }
+    
+    pBlock->pNext = NULL;
+    pBlock->size = size;
+    
+    SinglyLListNode *pNodes = (SinglyLListNode *)(pBlock + 1);
+    char *pItems = (char *)(pNodes + count);
+    for (int i = 0; i < count; i++) {
+        pNodes[i].pData = pItems + (size_t)i * itemSize;
+        pNodes[i].pNext = i + 1 < count ? &pNodes[i + 1] : NULL;
+    }
+    
+    pList->pHead = &pNodes[0];
+    pList->pTail = &pNodes[count - 1];
+    pList->length = count;
+    pList->pBlocks = pBlock;
+    
+    return pList;
+}
+
 #pragma mark - Singly Linked List Make List
 
 SinglyLList *SinglyLListInit(int itemSize) {
@@ -48,6 +112,46 @@ SinglyLList *SinglyLListInit(int itemSize) {
     pList->pTail = NULL;
     pList->itemSize = itemSize;
     pList->length = 0;
+    pList->pBlocks = NULL;
+    
+    return pList;
+}
+
+// Nodes and items are allocated in one block and linked in order
+SinglyLList *SinglyLListInitFromArray(const Array *pArr) {
+    if (!pArr) {
+        return NULL;
+    }
+    
+    SinglyLList *pList = sllInitWithBlock(ArrayItemSize(pArr), ArrayLength(pArr));
+    if (!pList) {
+        return NULL;
+    }
+    
+    SinglyLListNode *pNode = pList->pHead;
+    for (int i = 0; pNode; i++) {
+        ArrayGetItem(pArr, i, pNode->pData);
+        pNode = pNode->pNext;
+    }
+    
+    return pList;
+}
+
+// Nodes and items are allocated in one block and linked in order
+SinglyLList *SinglyLListInitFromBuffer(int itemSize, const void *pBuf, int count) {
+    if (count < 0 || (count > 0 && !pBuf)) {
+        return NULL;
+    }
+    
+    SinglyLList *pList = sllInitWithBlock(itemSize, count);
+    if (!pList) {
+        return NULL;
+    }
+    
+    if (count > 0) {
+        // Items of the block are contiguous and in order
+        memcpy(pList->pHead->pData, pBuf, (size_t)count * itemSize);
+    }
     
     return pList;
 }
@@ -100,6 +204,25 @@ SinglyLList *SinglyLListConcat(const SinglyLList *pListA, const SinglyLList *pLi
 	return pOut;
 }
 
+Array *SinglyLListToArray(const SinglyLList *pList) {
+    if (!pList) {
+        return NULL;
+    }
+    
+    Array *pOut = ArrayInitWithLength(pList->itemSize, pList->length);
+    if (!pOut) {
+        return NULL;
+    }
+    
+    SinglyLListNode *pNode = pList->pHead;
+    for (int i = 0; pNode; i++) {
+        ArraySetItem(pOut, i, pNode->pData);
+        pNode = pNode->pNext;
+    }
+    
+    return pOut;
+}
+
 #pragma mark - Singly Linked List Get Properties
 
 int SinglyLListLength(const SinglyLList *pList) {
@@ -129,6 +252,12 @@ void SinglyLListClear(SinglyLList *pList) {
     while (pList->pHead) {
         SinglyLListDeleteItem(pList, 0);
     }
+    
+    while (pList->pBlocks) {
+        SinglyLListBlock *pNext = pList->pBlocks->pNext;
+        free(pList->pBlocks);
+        pList->pBlocks = pNext;
+    }
 }
 
 void SinglyLListTraverse(SinglyLList *pList, void (*pFunc)(void *)) {
@@ -496,8 +625,7 @@ bool SinglyLListDeleteItem(SinglyLList *pList, int index) {
         SinglyLListNode *pPrev = sllNodeAt(pList, index - 1);
         SinglyLListNode *pThis = pPrev->pNext;
         pPrev->pNext = pThis->pNext;
-        free(pThis->pData);
-        free(pThis);
+        sllFreeNode(pList, pThis);
         if (index == pList->length - 1) {
             pPrev->pNext = NULL;
             pList->pTail = pPrev;
@@ -505,8 +633,7 @@ bool SinglyLListDeleteItem(SinglyLList *pList, int index) {
     } else {
         SinglyLListNode *pThis = pList->pHead;
         pList->pHead = pThis->pNext;
-        free(pThis->pData);
-        free(pThis);
+        sllFreeNode(pList, pThis);
         if (pList->length == 1) {
             pList->pHead = NULL;
             pList->pTail = NULL;
@@ -524,3 +651,705 @@ bool SinglyLListDeleteHeadItem(SinglyLList *pList) {
 bool SinglyLListDeleteTailItem(SinglyLList *pList) {
     return SinglyLListDeleteItem(pList, pList->length - 1);
 }
+
+#pragma mark - Unrolled Linked List Structure
+
+// Target size of one node, a few cache lines
+#define UNROLLED_NODE_BYTES 256
+#define UNROLLED_MIN_NODE_CAPACITY 4
+
+typedef struct _unrolled_llist_node {
+    struct _unrolled_llist_node *pPrev;
+    struct _unrolled_llist_node *pNext;
+    int count;
+    // Items are stored right after the node header
+} UnrolledLListNode;
+
+struct _unrolled_llist {
+    UnrolledLListNode *pHead;
+    UnrolledLListNode *pTail;
+    int itemSize;
+    int length;
+    int nodeCapacity;
+    // Last located node and the index of its first item, makes sequential access O(1)
+    UnrolledLListNode *pCacheNode;
+    int cacheStart;
+};
+
+#pragma mark - Unrolled Linked List Inner Function
+
+static char *ullItemAt(const UnrolledLList *pList, const UnrolledLListNode *pNode, int offset) {
+    return (char *)(pNode + 1) + offset * pList->itemSize;
+}
+
+static UnrolledLListNode *ullNodeInit(const UnrolledLList *pList) {
+    UnrolledLListNode *pNode = malloc(sizeof(UnrolledLListNode) + pList->nodeCapacity * pList->itemSize);
+    if (!pNode) {
+        return NULL;
+    }
+    
+    pNode->pPrev = NULL;
+    pNode->pNext = NULL;
+    pNode->count = 0;
+    
+    return pNode;
+}
+
+static void ullLinkAfter(UnrolledLList *pList, UnrolledLListNode *pNode, UnrolledLListNode *pNewNode) {
+    pNewNode->pPrev = pNode;
+    pNewNode->pNext = pNode->pNext;
+    if (pNode->pNext) {
+        pNode->pNext->pPrev = pNewNode;
+    } else {
+        pList->pTail = pNewNode;
+    }
+    pNode->pNext = pNewNode;
+}
+
+static void ullUnlinkAndFree(UnrolledLList *pList, UnrolledLListNode *pNode) {
+    if (pNode->pPrev) {
+        pNode->pPrev->pNext = pNode->pNext;
+    } else {
+        pList->pHead = pNode->pNext;
+    }
+    if (pNode->pNext) {
+        pNode->pNext->pPrev = pNode->pPrev;
+    } else {
+        pList->pTail = pNode->pPrev;
+    }
+    if (pList->pCacheNode == pNode) {
+        pList->pCacheNode = NULL;
+    }
+    free(pNode);
+}
+
+// Index should be in range 0 to pList->length - 1
+static UnrolledLListNode *ullNodeAt(const UnrolledLList *pList, int index, int *pOffset) {
+    UnrolledLList *pMutableList = (UnrolledLList *)pList; // Only the cache is touched
+    
+    // Start from whichever of head, tail and the cached node is nearest
+    UnrolledLListNode *pNode = pList->pHead;
+    int start = 0;
+    int distance = index;
+    if (pList->length - index < distance) {
+        pNode = pList->pTail;
+        start = pList->length - pList->pTail->count;
+        distance = pList->length - index;
+    }
+    if (pList->pCacheNode && abs(index - pList->cacheStart) < distance) {
+        pNode = pList->pCacheNode;
+        start = pList->cacheStart;
+    }
+    
+    while (index < start) {
+        pNode = pNode->pPrev;
+        start -= pNode->count;
+    }
+    while (index >= start + pNode->count) {
+        start += pNode->count;
+        pNode = pNode->pNext;
+    }
+    
+    pMutableList->pCacheNode = pNode;
+    pMutableList->cacheStart = start;
+    *pOffset = index - start;
+    
+    return pNode;
+}
+
+// Stable bottom-up merge sort of count items in pData, pTemp should be as large as pData
+static void ullMergeSort(char *pData, char *pTemp, int count, int itemSize,
+                         int (*pCompareFunc)(const void *, const void *), bool ascend) {
+    char *pSrc = pData;
+    char *pDst = pTemp;
+    
+    for (int width = 1; width < count; width *= 2) {
+        for (int left = 0; left < count; left += 2 * width) {
+            int mid = left + width < count ? left + width : count;
+            int right = left + 2 * width < count ? left + 2 * width : count;
+            int i = left, j = mid, k = left;
+            while (i < mid && j < right) {
+                int result = pCompareFunc(pSrc + i * itemSize, pSrc + j * itemSize);
+                if ((ascend && result <= 0) || (!ascend && result >= 0)) {
+                    memcpy(pDst + (k++) * itemSize, pSrc + (i++) * itemSize, itemSize);
+                } else {
+                    memcpy(pDst + (k++) * itemSize, pSrc + (j++) * itemSize, itemSize);
+                }
+            }
+            memcpy(pDst + k * itemSize, pSrc + i * itemSize, (mid - i) * itemSize);
+            k += mid - i;
+            memcpy(pDst + k * itemSize, pSrc + j * itemSize, (right - j) * itemSize);
+        }
+        char *pT = pSrc;
+        pSrc = pDst;
+        pDst = pT;
+    }
+    
+    if (pSrc != pData) {
+        memcpy(pData, pSrc, count * itemSize);
+    }
+}
+
+#pragma mark - Unrolled Linked List Make List
+
+UnrolledLList *UnrolledLListInit(int itemSize) {
+    if (itemSize <= 0) {
+        return NULL;
+    }
+    
+    UnrolledLList *pList = malloc(sizeof(UnrolledLList));
+    if (!pList) {
+        return NULL;
+    }
+    
+    pList->pHead = NULL;
+    pList->pTail = NULL;
+    pList->itemSize = itemSize;
+    pList->length = 0;
+    pList->nodeCapacity = (int)((UNROLLED_NODE_BYTES - sizeof(UnrolledLListNode)) / itemSize);
+    if (pList->nodeCapacity < UNROLLED_MIN_NODE_CAPACITY) {
+        pList->nodeCapacity = UNROLLED_MIN_NODE_CAPACITY;
+    }
+    pList->pCacheNode = NULL;
+    pList->cacheStart = 0;
+    
+    return pList;
+}
+
+UnrolledLList *UnrolledLListSubList(const UnrolledLList *pList, int start, int length) {
+    if (!pList) {
+        return NULL;
+    }
+    
+    if (start < 0 || length < 0 || start + length > pList->length) {
+        return NULL;
+    }
+    
+    UnrolledLList *pOut = UnrolledLListInit(pList->itemSize);
+    if (!pOut) {
+        return NULL;
+    }
+    
+    if (length == 0) {
+        return pOut;
+    }
+    
+    int offset = 0;
+    UnrolledLListNode *pNode = ullNodeAt(pList, start, &offset);
+    for (int i = 0; i < length; i++) {
+        if (offset == pNode->count) {
+            pNode = pNode->pNext;
+            offset = 0;
+        }
+        if (!UnrolledLListAppendItem(pOut, ullItemAt(pList, pNode, offset))) {
+            UnrolledLListDestroy(pOut);
+            return NULL;
+        }
+        offset++;
+    }
+    
+    return pOut;
+}
+
+UnrolledLList *UnrolledLListCopy(const UnrolledLList *pList) {
+    return UnrolledLListSubList(pList, 0, pList->length);
+}
+
+UnrolledLList *UnrolledLListConcat(const UnrolledLList *pListA, const UnrolledLList *pListB) {
+    if (!pListA || !pListB) {
+        return NULL;
+    }
+    
+    UnrolledLList *pOut = UnrolledLListCopy(pListA);
+    if (!pOut) {
+        return NULL;
+    }
+    
+    if (!UnrolledLListAppendLList(pOut, pListB)) {
+        UnrolledLListDestroy(pOut);
+        return NULL;
+    }
+    
+    return pOut;
+}
+
+#pragma mark - Unrolled Linked List Get Properties
+
+int UnrolledLListLength(const UnrolledLList *pList) {
+    return pList ? pList->length : -1;
+}
+
+int UnrolledLListItemSize(const UnrolledLList *pList) {
+    return pList ? pList->itemSize : -1;
+}
+
+int UnrolledLListNodeCapacity(const UnrolledLList *pList) {
+    return pList ? pList->nodeCapacity : -1;
+}
+
+#pragma mark - Unrolled Linked List Manipulate Whole List
+
+void UnrolledLListDestroy(UnrolledLList *pList) {
+    if (!pList) {
+        return;
+    }
+    
+    UnrolledLListClear(pList);
+    free(pList);
+}
+
+void UnrolledLListClear(UnrolledLList *pList) {
+    if (!pList) {
+        return;
+    }
+    
+    UnrolledLListNode *pNode = pList->pHead;
+    while (pNode) {
+        UnrolledLListNode *pNext = pNode->pNext;
+        free(pNode);
+        pNode = pNext;
+    }
+    
+    pList->pHead = NULL;
+    pList->pTail = NULL;
+    pList->length = 0;
+    pList->pCacheNode = NULL;
+    pList->cacheStart = 0;
+}
+
+void UnrolledLListTraverse(UnrolledLList *pList, void (*pFunc)(void *)) {
+    if (!pList || !pFunc) {
+        return;
+    }
+    
+    for (UnrolledLListNode *pNode = pList->pHead; pNode; pNode = pNode->pNext) {
+        for (int i = 0; i < pNode->count; i++) {
+            pFunc(ullItemAt(pList, pNode, i));
+        }
+    }
+}
+
+bool UnrolledLListSort(UnrolledLList *pList, int (*pCompareFunc)(const void *, const void *), bool ascend) {
+    if (!pList || !pCompareFunc) {
+        return false;
+    }
+    
+    if (pList->length < 2) {
+        return true;
+    }
+    
+    // Sort a flat copy, so the original order is kept if memory is not enough
+    char *pData = malloc(2 * (size_t)pList->length * pList->itemSize);
+    if (!pData) {
+        return false;
+    }
+    
+    char *pCurr = pData;
+    for (UnrolledLListNode *pNode = pList->pHead; pNode; pNode = pNode->pNext) {
+        memcpy(pCurr, ullItemAt(pList, pNode, 0), pNode->count * pList->itemSize);
+        pCurr += pNode->count * pList->itemSize;
+    }
+    
+    ullMergeSort(pData, pData + pList->length * pList->itemSize, pList->length, pList->itemSize, pCompareFunc, ascend);
+    
+    pCurr = pData;
+    for (UnrolledLListNode *pNode = pList->pHead; pNode; pNode = pNode->pNext) {
+        memcpy(ullItemAt(pList, pNode, 0), pCurr, pNode->count * pList->itemSize);
+        pCurr += pNode->count * pList->itemSize;
+    }
+    
+    free(pData);
+    
+    return true;
+}
+
+bool UnrolledLListReverse(UnrolledLList *pList) {
+    if (!pList) {
+        return false;
+    }
+    
+    void *pTemp = malloc(pList->itemSize);
+    if (!pTemp) {
+        return false;
+    }
+    
+    UnrolledLListNode *pNode = pList->pHead;
+    while (pNode) {
+        for (int i = 0; i < pNode->count / 2; i++) {
+            char *pA = ullItemAt(pList, pNode, i);
+            char *pB = ullItemAt(pList, pNode, pNode->count - 1 - i);
+            memcpy(pTemp, pA, pList->itemSize);
+            memcpy(pA, pB, pList->itemSize);
+            memcpy(pB, pTemp, pList->itemSize);
+        }
+        
+        UnrolledLListNode *pNext = pNode->pNext;
+        pNode->pNext = pNode->pPrev;
+        pNode->pPrev = pNext;
+        pNode = pNext;
+    }
+    
+    pNode = pList->pHead;
+    pList->pHead = pList->pTail;
+    pList->pTail = pNode;
+    pList->pCacheNode = NULL;
+    
+    free(pTemp);
+    
+    return true;
+}
+
+// Return -1 if no such item, return -2 if parameters invalid
+int UnrolledLListFind(const UnrolledLList *pList, const void *pVal, int (*pCompareFunc)(const void *, const void *)) {
+    if (!pList || !pVal || !pCompareFunc) {
+        return -2;
+    }
+    
+    int start = 0;
+    for (UnrolledLListNode *pNode = pList->pHead; pNode; pNode = pNode->pNext) {
+        for (int i = 0; i < pNode->count; i++) {
+            if (0 == pCompareFunc(ullItemAt(pList, pNode, i), pVal)) {
+                return start + i;
+            }
+        }
+        start += pNode->count;
+    }
+    
+    return -1;
+}
+
+#pragma mark - Unrolled Linked List Manipulate Single Item
+
+bool UnrolledLListGetItem(const UnrolledLList *pList, int index, void *pOut) {
+    if (!pList || !pOut) {
+        return false;
+    }
+    
+    if (index < 0 || index >= pList->length) {
+        return false;
+    }
+    
+    int offset = 0;
+    UnrolledLListNode *pNode = ullNodeAt(pList, index, &offset);
+    memcpy(pOut, ullItemAt(pList, pNode, offset), pList->itemSize);
+    
+    return true;
+}
+
+bool UnrolledLListGetHeadItem(const UnrolledLList *pList, void *pOut) {
+    if (!pList || !pOut) {
+        return false;
+    }
+    
+    if (!pList->pHead) {
+        return false;
+    }
+    
+    memcpy(pOut, ullItemAt(pList, pList->pHead, 0), pList->itemSize);
+    
+    return true;
+}
+
+bool UnrolledLListGetTailItem(const UnrolledLList *pList, void *pOut) {
+    if (!pList || !pOut) {
+        return false;
+    }
+    
+    if (!pList->pTail) {
+        return false;
+    }
+    
+    memcpy(pOut, ullItemAt(pList, pList->pTail, pList->pTail->count - 1), pList->itemSize);
+    
+    return true;
+}
+
+bool UnrolledLListSetItem(UnrolledLList *pList, int index, const void *pIn) {
+    if (!pList || !pIn) {
+        return false;
+    }
+    
+    if (index < 0 || index >= pList->length) {
+        return false;
+    }
+    
+    int offset = 0;
+    UnrolledLListNode *pNode = ullNodeAt(pList, index, &offset);
+    memcpy(ullItemAt(pList, pNode, offset), pIn, pList->itemSize);
+    
+    return true;
+}
+
+// Accept index range from 0 to pList->length
+bool UnrolledLListInsertItem(UnrolledLList *pList, int index, const void *pIn) {
+    if (!pList || !pIn) {
+        return false;
+    }
+    
+    if (index < 0 || index > pList->length) {
+        return false;
+    }
+    
+    UnrolledLListNode *pNode = NULL;
+    int offset = 0;
+    int start = 0;
+    
+    if (pList->length == 0) {
+        pNode = ullNodeInit(pList);
+        if (!pNode) {
+            return false;
+        }
+        pList->pHead = pNode;
+        pList->pTail = pNode;
+    } else if (index == pList->length) {
+        pNode = pList->pTail;
+        start = pList->length - pNode->count;
+        offset = pNode->count;
+        if (pNode->count == pList->nodeCapacity) {
+            // Appending, start a new node instead of splitting so nodes stay full
+            UnrolledLListNode *pNewNode = ullNodeInit(pList);
+            if (!pNewNode) {
+                return false;
+            }
+            ullLinkAfter(pList, pNode, pNewNode);
+            pNode = pNewNode;
+            start = pList->length;
+            offset = 0;
+        }
+    } else {
+        pNode = ullNodeAt(pList, index, &offset);
+        start = index - offset;
+        if (pNode->count == pList->nodeCapacity) {
+            // Split the full node, move the upper half to a new node
+            UnrolledLListNode *pNewNode = ullNodeInit(pList);
+            if (!pNewNode) {
+                return false;
+            }
+            int keep = pNode->count / 2;
+            pNewNode->count = pNode->count - keep;
+            memcpy(ullItemAt(pList, pNewNode, 0), ullItemAt(pList, pNode, keep), pNewNode->count * pList->itemSize);
+            pNode->count = keep;
+            ullLinkAfter(pList, pNode, pNewNode);
+            
+            if (offset > keep) {
+                pNode = pNewNode;
+                start += keep;
+                offset -= keep;
+            }
+        }
+    }
+    
+    memmove(ullItemAt(pList, pNode, offset + 1), ullItemAt(pList, pNode, offset),
+            (pNode->count - offset) * pList->itemSize);
+    memcpy(ullItemAt(pList, pNode, offset), pIn, pList->itemSize);
+    pNode->count++;
+    pList->length++;
+    
+    pList->pCacheNode = pNode;
+    pList->cacheStart = start;
+    
+    return true;
+}
+
+// Accept index range from 0 to pList->length
+bool UnrolledLListInsertLList(UnrolledLList *pList, int index, const UnrolledLList *pNewList) {
+    if (!pList || !pNewList) {
+        return false;
+    }
+    
+    if (index < 0 || index > pList->length) {
+        return false;
+    }
+    
+    if (pList->itemSize != pNewList->itemSize) {
+        return false;
+    }
+    
+    // Inserting a list into itself, take a snapshot first
+    UnrolledLList *pTempList = NULL;
+    if (pList == pNewList) {
+        pTempList = UnrolledLListCopy(pNewList);
+        if (!pTempList) {
+            return false;
+        }
+        pNewList = pTempList;
+    }
+    
+    int inserted = 0;
+    for (UnrolledLListNode *pNode = pNewList->pHead; pNode; pNode = pNode->pNext) {
+        for (int i = 0; i < pNode->count; i++) {
+            if (!UnrolledLListInsertItem(pList, index + inserted, ullItemAt(pNewList, pNode, i))) {
+                // Delete the items inserted before
+                for (int j = 0; j < inserted; j++) {
+                    UnrolledLListDeleteItem(pList, index);
+                }
+                UnrolledLListDestroy(pTempList);
+                return false;
+            }
+            inserted++;
+        }
+    }
+    
+    UnrolledLListDestroy(pTempList);
+    
+    return true;
+}
+
+bool UnrolledLListAppendItem(UnrolledLList *pList, const void *pIn) {
+    return UnrolledLListInsertItem(pList, pList->length, pIn);
+}
+
+bool UnrolledLListAppendLList(UnrolledLList *pList, const UnrolledLList *pNewList) {
+    return UnrolledLListInsertLList(pList, pList->length, pNewList);
+}
+
+bool UnrolledLListPrependItem(UnrolledLList *pList, const void *pIn) {
+    return UnrolledLListInsertItem(pList, 0, pIn);
+}
+
+bool UnrolledLListPrependLList(UnrolledLList *pList, const UnrolledLList *pNewList) {
+    return UnrolledLListInsertLList(pList, 0, pNewList);
+}
+
+bool UnrolledLListMoveItem(UnrolledLList *pList, int oldIndex, int newIndex) {
+    if (!pList) {
+        return false;
+    }
+    
+    if (oldIndex < 0 || oldIndex >= pList->length || newIndex < 0 || newIndex >= pList->length) {
+        return false;
+    }
+    
+    if (oldIndex == newIndex) {
+        return true;
+    }
+    
+    void *pTemp = malloc(pList->itemSize);
+    if (!pTemp) {
+        return false;
+    }
+    
+    // Shift the items between in place, so no node has to be split
+    UnrolledLListGetItem(pList, oldIndex, pTemp);
+    if (oldIndex < newIndex) {
+        for (int i = oldIndex; i < newIndex; i++) {
+            UnrolledLListReplaceItemAWithB(pList, i, i + 1);
+        }
+    } else {
+        for (int i = oldIndex; i > newIndex; i--) {
+            UnrolledLListReplaceItemAWithB(pList, i, i - 1);
+        }
+    }
+    UnrolledLListSetItem(pList, newIndex, pTemp);
+    
+    free(pTemp);
+    
+    return true;
+}
+
+bool UnrolledLListSwapItems(UnrolledLList *pList, int aIndex, int bIndex) {
+    if (!pList) {
+        return false;
+    }
+    
+    if (aIndex < 0 || aIndex >= pList->length || bIndex < 0 || bIndex >= pList->length) {
+        return false;
+    }
+    
+    if (aIndex == bIndex) {
+        return true;
+    }
+    
+    void *pTemp = malloc(pList->itemSize);
+    if (!pTemp) {
+        return false;
+    }
+    
+    int aOffset = 0, bOffset = 0;
+    UnrolledLListNode *pNodeA = ullNodeAt(pList, aIndex, &aOffset);
+    UnrolledLListNode *pNodeB = ullNodeAt(pList, bIndex, &bOffset);
+    char *pA = ullItemAt(pList, pNodeA, aOffset);
+    char *pB = ullItemAt(pList, pNodeB, bOffset);
+    memcpy(pTemp, pA, pList->itemSize);
+    memcpy(pA, pB, pList->itemSize);
+    memcpy(pB, pTemp, pList->itemSize);
+    
+    free(pTemp);
+    
+    return true;
+}
+
+bool UnrolledLListReplaceItemAWithB(UnrolledLList *pList, int aIndex, int bIndex) {
+    if (!pList) {
+        return false;
+    }
+    
+    if (aIndex < 0 || aIndex >= pList->length || bIndex < 0 || bIndex >= pList->length) {
+        return false;
+    }
+    
+    if (aIndex == bIndex) {
+        return true;
+    }
+    
+    int aOffset = 0, bOffset = 0;
+    UnrolledLListNode *pNodeA = ullNodeAt(pList, aIndex, &aOffset);
+    UnrolledLListNode *pNodeB = ullNodeAt(pList, bIndex, &bOffset);
+    char *pA = ullItemAt(pList, pNodeA, aOffset);
+    char *pB = ullItemAt(pList, pNodeB, bOffset);
+    memcpy(pA, pB, pList->itemSize);
+    
+    return true;
+}
+
+bool UnrolledLListDeleteItem(UnrolledLList *pList, int index) {
+    if (!pList) {
+        return false;
+    }
+    
+    if (index < 0 || index >= pList->length) {
+        return false;
+    }
+    
+    int offset = 0;
+    UnrolledLListNode *pNode = ullNodeAt(pList, index, &offset);
+    int start = index - offset;
+    
+    memmove(ullItemAt(pList, pNode, offset), ullItemAt(pList, pNode, offset + 1),
+            (pNode->count - offset - 1) * pList->itemSize);
+    pNode->count--;
+    pList->length--;
+    
+    if (pNode->count == 0) {
+        ullUnlinkAndFree(pList, pNode);
+        return true;
+    }
+    
+    // Keep nodes at least half full, merge with or borrow from the next node
+    UnrolledLListNode *pNext = pNode->pNext;
+    if (pNode->count < pList->nodeCapacity / 2 && pNext) {
+        if (pNode->count + pNext->count <= pList->nodeCapacity) {
+            memcpy(ullItemAt(pList, pNode, pNode->count), ullItemAt(pList, pNext, 0), pNext->count * pList->itemSize);
+            pNode->count += pNext->count;
+            ullUnlinkAndFree(pList, pNext);
+        } else {
+            memcpy(ullItemAt(pList, pNode, pNode->count), ullItemAt(pList, pNext, 0), pList->itemSize);
+            pNode->count++;
+            pNext->count--;
+            memmove(ullItemAt(pList, pNext, 0), ullItemAt(pList, pNext, 1), pNext->count * pList->itemSize);
+        }
+    }
+    
+    pList->pCacheNode = pNode;
+    pList->cacheStart = start;
+    
+    return true;
+}
+
+bool UnrolledLListDeleteHeadItem(UnrolledLList *pList) {
+    return UnrolledLListDeleteItem(pList, 0);
+}
+
+bool UnrolledLListDeleteTailItem(UnrolledLList *pList) {
+    return UnrolledLListDeleteItem(pList, pList->length - 1);
+}
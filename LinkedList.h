@@ -13,17 +13,25 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include "DynamicArray.h"
 
 #pragma mark - Type Definition
 
 typedef struct _singly_llist SinglyLList;
+// Keep several items contiguously in each node, traverse almost as fast as an array
+typedef struct _unrolled_llist UnrolledLList;
 
 #pragma mark - Singly Linked List Make List
 
 SinglyLList *SinglyLListInit(int itemSize);
+// Nodes and items are allocated in one block and linked in order
+SinglyLList *SinglyLListInitFromArray(const Array *pArr);
+// Nodes and items are allocated in one block and linked in order
+SinglyLList *SinglyLListInitFromBuffer(int itemSize, const void *pBuf, int count);
 SinglyLList *SinglyLListSubList(const SinglyLList *pList, int start, int length);
 SinglyLList *SinglyLListCopy(const SinglyLList *pList);
 SinglyLList *SinglyLListConcat(const SinglyLList *pListA, const SinglyLList *pListB);
+Array       *SinglyLListToArray(const SinglyLList *pList);
 
 #pragma mark - Singly Linked List Get Properties
 
@@ -61,4 +69,50 @@ bool SinglyLListDeleteItem(SinglyLList *pList, int index);
 bool SinglyLListDeleteHeadItem(SinglyLList *pList);
 bool SinglyLListDeleteTailItem(SinglyLList *pList);
 
+#pragma mark - Unrolled Linked List Make List
+
+UnrolledLList *UnrolledLListInit(int itemSize);
+UnrolledLList *UnrolledLListSubList(const UnrolledLList *pList, int start, int length);
+UnrolledLList *UnrolledLListCopy(const UnrolledLList *pList);
+UnrolledLList *UnrolledLListConcat(const UnrolledLList *pListA, const UnrolledLList *pListB);
+
+#pragma mark - Unrolled Linked List Get Properties
+
+int UnrolledLListLength(const UnrolledLList *pList);
+int UnrolledLListItemSize(const UnrolledLList *pList);
+// Max count of items stored in one node
+int UnrolledLListNodeCapacity(const UnrolledLList *pList);
+
+#pragma mark - Unrolled Linked List Manipulate Whole List
+
+void UnrolledLListDestroy(UnrolledLList *pList);
+void UnrolledLListClear(UnrolledLList *pList);
+void UnrolledLListTraverse(UnrolledLList *pList, void (*pFunc)(void *));
+bool UnrolledLListSort(UnrolledLList *pList, int (*pCompareFunc)(const void *, const void *), bool ascend);
+bool UnrolledLListReverse(UnrolledLList *pList);
+// Return -1 if no such item, return -2 if parameters invalid
+int  UnrolledLListFind(const UnrolledLList *pList, const void *pVal, int (*pCompareFunc)(const void *, const void *));
+
+#pragma mark - Unrolled Linked List Manipulate Single Item
+
+// Accessing the index next to the last accessed one costs O(1)
+bool UnrolledLListGetItem(const UnrolledLList *pList, int index, void *pOut);
+bool UnrolledLListGetHeadItem(const UnrolledLList *pList, void *pOut);
+bool UnrolledLListGetTailItem(const UnrolledLList *pList, void *pOut);
+bool UnrolledLListSetItem(UnrolledLList *pList, int index, const void *pIn);
+// Accept index range from 0 to pList->length
+bool UnrolledLListInsertItem(UnrolledLList *pList, int index, const void *pIn);
+// Accept index range from 0 to pList->length
+bool UnrolledLListInsertLList(UnrolledLList *pList, int index, const UnrolledLList *pNewList);
+bool UnrolledLListAppendItem(UnrolledLList *pList, const void *pIn);
+bool UnrolledLListAppendLList(UnrolledLList *pList, const UnrolledLList *pNewList);
+bool UnrolledLListPrependItem(UnrolledLList *pList, const void *pIn);
+bool UnrolledLListPrependLList(UnrolledLList *pList, const UnrolledLList *pNewList);
+bool UnrolledLListMoveItem(UnrolledLList *pList, int oldIndex, int newIndex);
+bool UnrolledLListSwapItems(UnrolledLList *pList, int aIndex, int bIndex);
+bool UnrolledLListReplaceItemAWithB(UnrolledLList *pList, int aIndex, int bIndex);
+bool UnrolledLListDeleteItem(UnrolledLList *pList, int index);
+bool UnrolledLListDeleteHeadItem(UnrolledLList *pList);
+bool UnrolledLListDeleteTailItem(UnrolledLList *pList);
+
 #endif
@@ -0,0 +1,406 @@
+//
+//  MultiPatternMatcher.c
+//  DataStructure
+//
+
+#include "MultiPatternMatcher.h"
+#include <limits.h>
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Matcher Structure
+
+// State 0 is the root, pDelta holds the full transition of every state, so scanning never follows failure links
+struct _multi_pattern_matcher {
+    unsigned char byteClass[256];
+    int classCount;
+    int stateCount;
+    // stateCount * classCount
+    int *pDelta;
+    // Per state, first pattern ending exactly there, or -1
+    int *pPatternOf;
+    // Per state, nearest state on the failure chain where a pattern ends, or -1
+    int *pOutputLink;
+    // Per pattern, next pattern equal to it, or -1
+    int *pNextPattern;
+    int *pPatternLengths;
+    int patternCount;
+};
+
+struct _multi_pattern_stream {
+    const MultiPatternMatcher *pMatcher;
+    int state;
+    long long position;
+};
+
+#pragma mark - Inner Function
+
+static const char *patternAt(const Array *pArr, int index, bool isCString, int *pLength) {
+    if (isCString) {
+        const char *pCStr = ((const char **)pArr->pData)[index];
+        size_t length = pCStr ? strlen(pCStr) : 0;
+        *pLength = length > INT_MAX ? 0 : (int)length;
+        return pCStr;
+    }
+    
+    const String *pStr = ((const String **)pArr->pData)[index];
+    *pLength = pStr ? pStr->length : 0;
+    return pStr ? pStr->pData : NULL;
+}
+
+static MultiPatternMatcher *matcherInit(const Array *pArr, bool isCString) {
+    if (!pArr || pArr->length == 0 || pArr->itemSize != sizeof(void *)) {
+        return NULL;
+    }
+    
+    MultiPatternMatcher *pMatcher = calloc(1, sizeof(MultiPatternMatcher));
+    if (!pMatcher) {
+        return NULL;
+    }
+    
+    // Give every byte used by some pattern its own class, the rest share class 0
+    bool isUsed[256] = { false };
+    long long totalLength = 0;
+    for (int i = 0; i < pArr->length; i++) {
+        int length;
+        const unsigned char *pPattern = (const unsigned char *)patternAt(pArr, i, isCString, &length);
+        if (length == 0) {
+            free(pMatcher);
+            return NULL;
+        }
+        for (int j = 0; j < length; j++) {
+            isUsed[pPattern[j]] = true;
+        }
+        totalLength += length;
+    }
+    
+    pMatcher->classCount = 1;
+    for (int b = 0; b < 256; b++) {
+        pMatcher->byteClass[b] = isUsed[b] ? (unsigned char)pMatcher->classCount++ : 0;
+    }
+    
+    if (totalLength + 1 > INT_MAX / pMatcher->classCount) {
+        free(pMatcher);
+        return NULL;
+    }
+    int maxStates = (int)totalLength + 1;
+    int classCount = pMatcher->classCount;
+    
+    pMatcher->patternCount = pArr->length;
+    pMatcher->pDelta = malloc(sizeof(int) * maxStates * classCount);
+    pMatcher->pPatternOf = malloc(sizeof(int) * maxStates);
+    pMatcher->pOutputLink = malloc(sizeof(int) * maxStates);
+    pMatcher->pNextPattern = malloc(sizeof(int) * pArr->length);
+    pMatcher->pPatternLengths = malloc(sizeof(int) * pArr->length);
+    int *pFail = malloc(sizeof(int) * maxStates);
+    if (!pMatcher->pDelta || !pMatcher->pPatternOf || !pMatcher->pOutputLink
+        || !pMatcher->pNextPattern || !pMatcher->pPatternLengths || !pFail) {
+        free(pFail);
+        MultiPatternMatcherDestroy(pMatcher);
+        return NULL;
+    }
+    
+    // Build the trie
+    for (int i = 0; i < maxStates * classCount; i++) {
+        pMatcher->pDelta[i] = -1;
+    }
+    pMatcher->stateCount = 1;
+    pMatcher->pPatternOf[0] = -1;
+    
+    for (int i = 0; i < pArr->length; i++) {
+        int length;
+        const unsigned char *pPattern = (const unsigned char *)patternAt(pArr, i, isCString, &length);
+        
+        int state = 0;
+        for (int j = 0; j < length; j++) {
+            int *pNext = pMatcher->pDelta + state * classCount + pMatcher->byteClass[pPattern[j]];
+            if (*pNext < 0) {
+                *pNext = pMatcher->stateCount;
+                pMatcher->pPatternOf[pMatcher->stateCount] = -1;
+                pMatcher->stateCount++;
+            }
+            state = *pNext;
+        }
+        
+        // Equal patterns chain behind the first one in their original order
+        pMatcher->pPatternLengths[i] = length;
+        pMatcher->pNextPattern[i] = -1;
+        if (pMatcher->pPatternOf[state] < 0) {
+            pMatcher->pPatternOf[state] = i;
+        } else {
+            int last = pMatcher->pPatternOf[state];
+            while (pMatcher->pNextPattern[last] >= 0) {
+                last = pMatcher->pNextPattern[last];
+            }
+            pMatcher->pNextPattern[last] = i;
+        }
+    }
+    
+    // Breadth first, so the failure state of a state is complete before the state itself,
+    // missing transitions are filled from the failure state
+    int *pQueue = malloc(sizeof(int) * pMatcher->stateCount);
+    if (!pQueue) {
+        free(pFail);
+        MultiPatternMatcherDestroy(pMatcher);
+        return NULL;
+    }
+    int head = 0, tail = 0;
+    
+    pFail[0] = 0;
+    pMatcher->pOutputLink[0] = -1;
+    for (int c = 0; c < classCount; c++) {
+        int *pNext = pMatcher->pDelta + c;
+        if (*pNext < 0) {
+            *pNext = 0;
+        } else {
+            pFail[*pNext] = 0;
+            pMatcher->pOutputLink[*pNext] = -1;
+            pQueue[tail++] = *pNext;
+        }
+    }
+    
+    while (head < tail) {
+        int state = pQueue[head++];
+        int *pRow = pMatcher->pDelta + state * classCount;
+        const int *pFailRow = pMatcher->pDelta + pFail[state] * classCount;
+        
+        for (int c = 0; c < classCount; c++) {
+            int next = pRow[c];
+            if (next < 0) {
+                pRow[c] = pFailRow[c];
+                continue;
+            }
+            
+            int fail = pFailRow[c];
+            pFail[next] = fail;
+            pMatcher->pOutputLink[next] = pMatcher->pPatternOf[fail] >= 0 ? fail : pMatcher->pOutputLink[fail];
+            pQueue[tail++] = next;
+        }
+    }
+    
+    free(pQueue);
+    free(pFail);
+    
+    // Give back the rows reserved for states that shared prefixes saved
+    int *pDelta = realloc(pMatcher->pDelta, sizeof(int) * pMatcher->stateCount * classCount);
+    if (pDelta) {
+        pMatcher->pDelta = pDelta;
+    }
+    
+    return pMatcher;
+}
+
+// Scan from start in state *pState, call pFunc with the end and pattern of every match, stop when it returns false
+// Return false if stopped, *pState is the state after the last byte scanned
+static bool matcherScan(const MultiPatternMatcher *pMatcher, const char *pData, int length, int start, int *pState,
+                        bool (*pFunc)(int end, int patternIndex, int patternLength, void *pContext), void *pContext) {
+    const unsigned char *pText = (const unsigned char *)pData;
+    const int *pDelta = pMatcher->pDelta;
+    int classCount = pMatcher->classCount;
+    
+    int state = *pState;
+    for (int i = start; i < length; i++) {
+        state = pDelta[state * classCount + pMatcher->byteClass[pText[i]]];
+        
+        int outState = pMatcher->pPatternOf[state] >= 0 ? state : pMatcher->pOutputLink[state];
+        // Deeper states first, so longer patterns come first
+        for (; outState >= 0; outState = pMatcher->pOutputLink[outState]) {
+            for (int p = pMatcher->pPatternOf[outState]; p >= 0; p = pMatcher->pNextPattern[p]) {
+                if (!pFunc(i + 1, p, pMatcher->pPatternLengths[p], pContext)) {
+                    *pState = state;
+                    return false;
+                }
+            }
+        }
+    }
+    
+    *pState = state;
+    return true;
+}
+
+static bool takeFirst(int end, int patternIndex, int patternLength, void *pContext) {
+    MultiPatternMatch *pMatch = pContext;
+    pMatch->index = end - patternLength;
+    pMatch->length = patternLength;
+    pMatch->patternIndex = patternIndex;
+    
+    return false;
+}
+
+// Return false when memory is not enough, which stops the scan
+static bool appendMatch(int end, int patternIndex, int patternLength, void *pContext) {
+    MultiPatternMatch match;
+    match.index = end - patternLength;
+    match.length = patternLength;
+    match.patternIndex = patternIndex;
+    
+    return ArrayAppendItem(pContext, &match);
+}
+
+typedef struct _stream_context {
+    Array *pMatches;
+    long long chunkStart;
+} StreamContext;
+
+// Return false when memory is not enough, which stops the scan
+static bool appendStreamMatch(int end, int patternIndex, int patternLength, void *pContext) {
+    StreamContext *pStreamContext = pContext;
+    MultiPatternStreamMatch match;
+    match.index = pStreamContext->chunkStart + end - patternLength;
+    match.length = patternLength;
+    match.patternIndex = patternIndex;
+    
+    return ArrayAppendItem(pStreamContext->pMatches, &match);
+}
+
+#pragma mark - Make Matcher
+
+// Accept Array of String, patterns should not be empty
+MultiPatternMatcher *MultiPatternMatcherInit(const Array *pStrArr) {
+    return matcherInit(pStrArr, false);
+}
+
+// Accept Array of C string, patterns should not be empty
+MultiPatternMatcher *MultiPatternMatcherInitWithCStrings(const Array *pCStrArr) {
+    return matcherInit(pCStrArr, true);
+}
+
+void MultiPatternMatcherDestroy(MultiPatternMatcher *pMatcher) {
+    if (!pMatcher) {
+        return;
+    }
+    
+    free(pMatcher->pDelta);
+    free(pMatcher->pPatternOf);
+    free(pMatcher->pOutputLink);
+    free(pMatcher->pNextPattern);
+    free(pMatcher->pPatternLengths);
+    free(pMatcher);
+}
+
+#pragma mark - Get Properties
+
+int MultiPatternMatcherPatternCount(const MultiPatternMatcher *pMatcher) {
+    return pMatcher ? pMatcher->patternCount : 0;
+}
+
+#pragma mark - Search
+
+// Search from index start, find the match that ends first, the longest one if several end there
+// Return false if no match or parameters invalid
+bool MultiPatternMatcherFind(const MultiPatternMatcher *pMatcher, const String *pStr, int start, MultiPatternMatch *pOut) {
+    if (!pStr) {
+        return false;
+    }
+    
+    return MultiPatternMatcherFindInBytes(pMatcher, pStr->pData, pStr->length, start, pOut);
+}
+
+bool MultiPatternMatcherFindInBytes(const MultiPatternMatcher *pMatcher, const char *pData, int length, int start, MultiPatternMatch *pOut) {
+    if (!pMatcher || !pOut || length < 0 || (!pData && length > 0) || start < 0) {
+        return false;
+    }
+    
+    int state = 0;
+    
+    return !matcherScan(pMatcher, pData, length, start, &state, takeFirst, pOut);
+}
+
+// Return Array of MultiPatternMatch, all matches including overlapping ones, ordered by where they end
+Array *MultiPatternMatcherFindAll(const MultiPatternMatcher *pMatcher, const String *pStr) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    return MultiPatternMatcherFindAllInBytes(pMatcher, pStr->pData, pStr->length);
+}
+
+Array *MultiPatternMatcherFindAllInBytes(const MultiPatternMatcher *pMatcher, const char *pData, int length) {
+    if (!pMatcher || length < 0 || (!pData && length > 0)) {
+        return NULL;
+    }
+    
+    Array *pMatches = ArrayInit(sizeof(MultiPatternMatch));
+    if (!pMatches) {
+        return NULL;
+    }
+    
+    int state = 0;
+    if (!matcherScan(pMatcher, pData, length, 0, &state, appendMatch, pMatches)) {
+        ArrayDestroy(pMatches);
+        return NULL;
+    }
+    
+    return pMatches;
+}
+
+bool MultiPatternMatcherContains(const MultiPatternMatcher *pMatcher, const String *pStr) {
+    MultiPatternMatch match;
+    
+    return MultiPatternMatcherFind(pMatcher, pStr, 0, &match);
+}
+
+#pragma mark - Stream Search
+
+// pMatcher should not be destroyed before the stream
+MultiPatternStream *MultiPatternStreamInit(const MultiPatternMatcher *pMatcher) {
+    if (!pMatcher) {
+        return NULL;
+    }
+    
+    MultiPatternStream *pStream = malloc(sizeof(MultiPatternStream));
+    if (!pStream) {
+        return NULL;
+    }
+    
+    pStream->pMatcher = pMatcher;
+    MultiPatternStreamReset(pStream);
+    
+    return pStream;
+}
+
+void MultiPatternStreamDestroy(MultiPatternStream *pStream) {
+    free(pStream);
+}
+
+// Forget everything fed, start a new stream
+void MultiPatternStreamReset(MultiPatternStream *pStream) {
+    if (!pStream) {
+        return;
+    }
+    
+    pStream->state = 0;
+    pStream->position = 0;
+}
+
+// Number of bytes fed since init or reset
+long long MultiPatternStreamPosition(const MultiPatternStream *pStream) {
+    return pStream ? pStream->position : 0;
+}
+
+// Append to pMatches (Array of MultiPatternStreamMatch) all matches ending in the chunk,
+// including the ones spanning earlier chunks, return false if parameters invalid or memory is not enough
+bool MultiPatternStreamFeed(MultiPatternStream *pStream, const char *pChunk, int length, Array *pMatches) {
+    if (!pStream || !pMatches || pMatches->itemSize != sizeof(MultiPatternStreamMatch) || length < 0 || (!pChunk && length > 0)) {
+        return false;
+    }
+    
+    StreamContext context;
+    context.pMatches = pMatches;
+    context.chunkStart = pStream->position;
+    
+    // The automaton state remembers as much of the earlier chunks as any pattern needs
+    bool result = matcherScan(pStream->pMatcher, pChunk, length, 0, &pStream->state, appendStreamMatch, &context);
+    pStream->position += length;
+    
+    return result;
+}
@@ -0,0 +1,74 @@
+//
+//  MultiPatternMatcher.h
+//  DataStructure
+//
+
+#ifndef __MultiPatternMatcher__
+#define __MultiPatternMatcher__
+
+#include <stdio.h>
+#include "String.h"
+
+// Searches many patterns in one pass (Aho-Corasick), the cost is proportional to the text length.
+// Patterns are compiled into a dense transition table over byte classes,
+// bytes that appear in no pattern share one class.
+
+#pragma mark - Type Definition
+
+typedef struct _multi_pattern_matcher MultiPatternMatcher;
+
+// Searches input that arrives in chunks, only the automaton state is kept between chunks
+typedef struct _multi_pattern_stream MultiPatternStream;
+
+typedef struct _multi_pattern_match {
+    // Where the match starts in the text
+    int index;
+    int length;
+    // Index of the pattern in the Array the matcher was made from
+    int patternIndex;
+} MultiPatternMatch;
+
+typedef struct _multi_pattern_stream_match {
+    // Stream offset where the match starts
+    long long index;
+    int length;
+    int patternIndex;
+} MultiPatternStreamMatch;
+
+#pragma mark - Make Matcher
+
+// Accept Array of String, patterns should not be empty
+MultiPatternMatcher *MultiPatternMatcherInit(const Array *pStrArr);
+// Accept Array of C string, patterns should not be empty
+MultiPatternMatcher *MultiPatternMatcherInitWithCStrings(const Array *pCStrArr);
+void MultiPatternMatcherDestroy(MultiPatternMatcher *pMatcher);
+
+#pragma mark - Get Properties
+
+int MultiPatternMatcherPatternCount(const MultiPatternMatcher *pMatcher);
+
+#pragma mark - Search
+
+// Search from index start, find the match that ends first, the longest one if several end there
+// Return false if no match or parameters invalid
+bool MultiPatternMatcherFind(const MultiPatternMatcher *pMatcher, const String *pStr, int start, MultiPatternMatch *pOut);
+bool MultiPatternMatcherFindInBytes(const MultiPatternMatcher *pMatcher, const char *pData, int length, int start, MultiPatternMatch *pOut);
+// Return Array of MultiPatternMatch, all matches including overlapping ones, ordered by where they end
+Array *MultiPatternMatcherFindAll(const MultiPatternMatcher *pMatcher, const String *pStr);
+Array *MultiPatternMatcherFindAllInBytes(const MultiPatternMatcher *pMatcher, const char *pData, int length);
+bool MultiPatternMatcherContains(const MultiPatternMatcher *pMatcher, const String *pStr);
+
+#pragma mark - Stream Search
+
+// pMatcher should not be destroyed before the stream
+MultiPatternStream *MultiPatternStreamInit(const MultiPatternMatcher *pMatcher);
+void MultiPatternStreamDestroy(MultiPatternStream *pStream);
+// Forget everything fed, start a new stream
+void MultiPatternStreamReset(MultiPatternStream *pStream);
+// Number of bytes fed since init or reset
+long long MultiPatternStreamPosition(const MultiPatternStream *pStream);
+// Append to pMatches (Array of MultiPatternStreamMatch) all matches ending in the chunk,
+// including the ones spanning earlier chunks, return false if parameters invalid or memory is not enough
+bool MultiPatternStreamFeed(MultiPatternStream *pStream, const char *pChunk, int length, Array *pMatches);
+
+#endif
@@ -0,0 +1,318 @@
+//
+//  RabinKarp.c
+//  DataStructure
+//
+
+#include "RabinKarp.h"
+#include <limits.h>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// 2^61 - 1, a Mersenne prime, so reducing is a shift and an add
+#define RK_MODULUS (((uint64_t)1 << 61) - 1)
+#define RK_BASE ((uint64_t)0x1A2B3C4D5E6F789ULL)
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Iterator Structure
+
+struct _shingle_iterator {
+    // Shares the buffer of the String the iterator is made from, NULL if made from bytes
+    String *pStr;
+    const unsigned char *pData;
+    int length;
+    int window;
+    // BASE^(window - 1), for taking the leaving character out
+    uint64_t leadPower;
+    // Index of the next window and the hash of the window before it
+    int next;
+    uint64_t hash;
+};
+
+#pragma mark - Inner Function
+
+// a and b are less than 2^61 - 1
+static uint64_t mulMod(uint64_t a, uint64_t b) {
+    uint64_t low, high;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    low = (uint64_t)product & RK_MODULUS;
+    high = (uint64_t)(product >> 61);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t productHigh;
+    uint64_t productLow = _umul128(a, b, &productHigh);
+    low = productLow & RK_MODULUS;
+    high = (productLow >> 61) | (productHigh << 3);
+#else
+    // Split into 31 and 30 bit halves so no partial product overflows
+    uint64_t aHigh = a >> 31, aLow = a & 0x7FFFFFFF;
+    uint64_t bHigh = b >> 31, bLow = b & 0x7FFFFFFF;
+    uint64_t middle = aLow * bHigh + aHigh * bLow;
+    uint64_t sum = ((aHigh * bHigh) << 1) + (middle >> 30) + ((middle & 0x3FFFFFFF) << 31) + aLow * bLow;
+    low = sum & RK_MODULUS;
+    high = sum >> 61;
+#endif
+    uint64_t result = low + high;
+    return result >= RK_MODULUS ? result - RK_MODULUS : result;
+}
+
+static uint64_t addMod(uint64_t a, uint64_t b) {
+    uint64_t result = a + b;
+    return result >= RK_MODULUS ? result - RK_MODULUS : result;
+}
+
+static uint64_t powerMod(uint64_t base, int exponent) {
+    uint64_t result = 1;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result = mulMod(result, base);
+        }
+        base = mulMod(base, base);
+        exponent >>= 1;
+    }
+    
+    return result;
+}
+
+// Slide the window, dropping leaving and taking entering
+static uint64_t roll(uint64_t hash, unsigned char leaving, unsigned char entering, uint64_t leadPower) {
+    hash = addMod(hash, RK_MODULUS - mulMod(leaving, leadPower));
+    return addMod(mulMod(hash, RK_BASE), entering);
+}
+
+#pragma mark - Hash
+
+// The same hash ShingleIteratorNext gives a window of the same characters
+uint64_t RabinKarpHash(const char *pBytes, int length) {
+    if (!pBytes || length < 0) {
+        return 0;
+    }
+    
+    const unsigned char *pData = (const unsigned char *)pBytes;
+    uint64_t hash = 0;
+    for (int i = 0; i < length; i++) {
+        hash = addMod(mulMod(hash, RK_BASE), pData[i]);
+    }
+    
+    return hash;
+}
+
+#pragma mark - Search
+
+// Return Array of int, the indexes of all occurrences including overlapping ones, the length of pSub should be greater than 0
+Array *StringFindAllRK(const String *pStr, const String *pSub) {
+    if (!pStr || !pSub || pSub->length <= 0) {
+        return NULL;
+    }
+    
+    Array *pIndexes = ArrayInit(sizeof(int));
+    if (!pIndexes) {
+        return NULL;
+    }
+    
+    int m = pSub->length;
+    int n = pStr->length;
+    if (n < m) {
+        return pIndexes;
+    }
+    
+    const unsigned char *pData = pStr->pData;
+    uint64_t target = RabinKarpHash(pSub->pData, m);
+    uint64_t hash = RabinKarpHash(pStr->pData, m);
+    uint64_t leadPower = powerMod(RK_BASE, m - 1);
+    
+    for (int i = 0; ; i++) {
+        if (hash == target && memcmp(pData + i, pSub->pData, m) == 0 && !ArrayAppendItem(pIndexes, &i)) {
+            ArrayDestroy(pIndexes);
+            return NULL;
+        }
+        if (i + m >= n) {
+            break;
+        }
+        hash = roll(hash, pData[i], pData[i + m], leadPower);
+    }
+    
+    return pIndexes;
+}
+
+// Accept Array of String of one length greater than 0, return Array of RabinKarpMatch ordered by index,
+// all occurrences of all patterns including overlapping ones, equal patterns all match
+Array *StringFindAllRKSet(const String *pStr, const Array *pSubArr) {
+    if (!pStr || !pSubArr || pSubArr->length == 0) {
+        return NULL;
+    }
+    
+    const String **ppSubs = pSubArr->pData;
+    int count = pSubArr->length;
+    int m = ppSubs[0] ? ppSubs[0]->length : 0;
+    for (int i = 0; i < count; i++) {
+        if (!ppSubs[i] || m <= 0 || ppSubs[i]->length != m) {
+            return NULL;
+        }
+    }
+    
+    // Open addressing with linear probing, at most half full, equal hashes stay in pattern order along the probe
+    int slotCount = 2;
+    while (slotCount < count * 2) {
+        if (slotCount > INT_MAX / 2) {
+            return NULL;
+        }
+        slotCount *= 2;
+    }
+    uint64_t *pSlotHashes = malloc(slotCount * sizeof(uint64_t));
+    int *pSlotPatterns = malloc(slotCount * sizeof(int));
+    Array *pMatches = ArrayInit(sizeof(RabinKarpMatch));
+    if (!pSlotHashes || !pSlotPatterns || !pMatches) {
+        free(pSlotHashes);
+        free(pSlotPatterns);
+        ArrayDestroy(pMatches);
+        return NULL;
+    }
+    for (int i = 0; i < slotCount; i++) {
+        pSlotPatterns[i] = -1;
+    }
+    
+    int mask = slotCount - 1;
+    for (int i = 0; i < count; i++) {
+        uint64_t hash = RabinKarpHash(ppSubs[i]->pData, m);
+        int slot = (int)(hash & mask);
+        while (pSlotPatterns[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        pSlotHashes[slot] = hash;
+        pSlotPatterns[slot] = i;
+    }
+    
+    int n = pStr->length;
+    const unsigned char *pData = pStr->pData;
+    if (n >= m) {
+        uint64_t hash = RabinKarpHash(pStr->pData, m);
+        uint64_t leadPower = powerMod(RK_BASE, m - 1);
+        
+        for (int i = 0; ; i++) {
+            for (int slot = (int)(hash & mask); pSlotPatterns[slot] >= 0; slot = (slot + 1) & mask) {
+                int pattern = pSlotPatterns[slot];
+                if (pSlotHashes[slot] != hash || memcmp(pData + i, ppSubs[pattern]->pData, m) != 0) {
+                    continue;
+                }
+                
+                RabinKarpMatch match = {i, pattern};
+                if (!ArrayAppendItem(pMatches, &match)) {
+                    free(pSlotHashes);
+                    free(pSlotPatterns);
+                    ArrayDestroy(pMatches);
+                    return NULL;
+                }
+            }
+            if (i + m >= n) {
+                break;
+            }
+            hash = roll(hash, pData[i], pData[i + m], leadPower);
+        }
+    }
+    
+    free(pSlotHashes);
+    free(pSlotPatterns);
+    
+    return pMatches;
+}
+
+#pragma mark - Shingle Iterator
+
+// The iterator shares pStr's buffer, changes to pStr don't affect it, the window should be greater than 0
+ShingleIterator *ShingleIteratorInit(const String *pStr, int window) {
+    if (!pStr || window <= 0) {
+        return NULL;
+    }
+    
+    // Changes to pStr copy its buffer first, so the shared characters stay the same
+    String *pCopy = StringCopy(pStr);
+    if (!pCopy) {
+        return NULL;
+    }
+    
+    ShingleIterator *pIter = ShingleIteratorInitWithBytes(pCopy->pData, pCopy->length, window);
+    if (!pIter) {
+        StringDestroy(pCopy);
+        return NULL;
+    }
+    pIter->pStr = pCopy;
+    
+    return pIter;
+}
+
+// No copy, pBytes should stay unchanged until the iterator is destroyed, the window should be greater than 0
+ShingleIterator *ShingleIteratorInitWithBytes(const char *pBytes, int length, int window) {
+    if ((!pBytes && length > 0) || length < 0 || window <= 0) {
+        return NULL;
+    }
+    
+    ShingleIterator *pIter = malloc(sizeof(ShingleIterator));
+    if (!pIter) {
+        return NULL;
+    }
+    
+    pIter->pStr = NULL;
+    pIter->pData = (const unsigned char *)pBytes;
+    pIter->length = length;
+    pIter->window = window;
+    pIter->leadPower = powerMod(RK_BASE, window - 1);
+    pIter->next = 0;
+    pIter->hash = 0;
+    
+    return pIter;
+}
+
+void ShingleIteratorDestroy(ShingleIterator *pIter) {
+    if (!pIter) {
+        return;
+    }
+    
+    StringDestroy(pIter->pStr);
+    free(pIter);
+}
+
+// Start again from the first window
+void ShingleIteratorReset(ShingleIterator *pIter) {
+    if (!pIter) {
+        return;
+    }
+    
+    pIter->next = 0;
+    pIter->hash = 0;
+}
+
+// Give the index and hash of the next window, return false after the last one
+bool ShingleIteratorNext(ShingleIterator *pIter, int *pIndex, uint64_t *pHash) {
+    if (!pIter || pIter->window > pIter->length - pIter->next) {
+        return false;
+    }
+    
+    int index = pIter->next;
+    if (index == 0) {
+        pIter->hash = RabinKarpHash((const char *)pIter->pData, pIter->window);
+    } else {
+        pIter->hash = roll(pIter->hash, pIter->pData[index - 1], pIter->pData[index - 1 + pIter->window], pIter->leadPower);
+    }
+    pIter->next++;
+    
+    if (pIndex) {
+        *pIndex = index;
+    }
+    if (pHash) {
+        *pHash = pIter->hash;
+    }
+    
+    return true;
+}
@@ -0,0 +1,54 @@
+//
+//  RabinKarp.h
+//  DataStructure
+//
+
+#ifndef __RabinKarp__
+#define __RabinKarp__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "String.h"
+
+// Rolling polynomial hash modulo the prime 2^61 - 1, sliding the window by one character is O(1).
+// Searches compare the characters of every hash hit, so they never report a false match.
+// The base is fixed, so equal windows hash the same across strings and runs.
+
+#pragma mark - Type Definition
+
+// Hashes of every window of one length in a string, in order
+typedef struct _shingle_iterator ShingleIterator;
+
+typedef struct _rabin_karp_match {
+    // Where the match starts in the text
+    int index;
+    // Index of the pattern in the Array the search was given
+    int patternIndex;
+} RabinKarpMatch;
+
+#pragma mark - Hash
+
+// The same hash ShingleIteratorNext gives a window of the same characters
+uint64_t RabinKarpHash(const char *pBytes, int length);
+
+#pragma mark - Search
+
+// Return Array of int, the indexes of all occurrences including overlapping ones, the length of pSub should be greater than 0
+Array *StringFindAllRK(const String *pStr, const String *pSub);
+// Accept Array of String of one length greater than 0, return Array of RabinKarpMatch ordered by index,
+// all occurrences of all patterns including overlapping ones, equal patterns all match
+Array *StringFindAllRKSet(const String *pStr, const Array *pSubArr);
+
+#pragma mark - Shingle Iterator
+
+// The iterator shares pStr's buffer, changes to pStr don't affect it, the window should be greater than 0
+ShingleIterator *ShingleIteratorInit(const String *pStr, int window);
+// No copy, pBytes should stay unchanged until the iterator is destroyed, the window should be greater than 0
+ShingleIterator *ShingleIteratorInitWithBytes(const char *pBytes, int length, int window);
+void ShingleIteratorDestroy(ShingleIterator *pIter);
+// Start again from the first window
+void ShingleIteratorReset(ShingleIterator *pIter);
+// Give the index and hash of the next window, return false after the last one
+bool ShingleIteratorNext(ShingleIterator *pIter, int *pIndex, uint64_t *pHash);
+
+#endif
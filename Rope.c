@@ -0,0 +1,923 @@
+//
+//  Rope.c
+//  DataStructure
+//
+
+#include "Rope.h"
+#include "StringSearch.h"
+#include <limits.h>
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Rope Structure
+
+// Text is cut into chunks of at most this many bytes
+#define ROPE_LEAF_MAX 512
+// Enough for any AVL tree with less than 2^31 leaves
+#define ROPE_MAX_HEIGHT 64
+
+// Nodes are immutable once built and shared between ropes through refCount.
+// A leaf has no children and height 0, its text follows the header.
+typedef struct _rope_node {
+    int refCount;
+    int length;
+    int height;
+    struct _rope_node *pLeft;
+    struct _rope_node *pRight;
+    char data[];
+} RopeNode;
+
+// Empty rope has pRoot NULL
+struct _rope {
+    RopeNode *pRoot;
+};
+
+// Walks the leaves in order
+typedef struct _rope_leaf_iterator {
+    const RopeNode *stack[ROPE_MAX_HEIGHT];
+    int depth;
+} RopeLeafIterator;
+
+#pragma mark - Inner Function
+
+static bool isLeaf(const RopeNode *pNode) {
+    return !pNode->pLeft;
+}
+
+static RopeNode *ropeRetain(RopeNode *pNode) {
+    if (pNode) {
+        pNode->refCount++;
+    }
+    
+    return pNode;
+}
+
+static void ropeRelease(RopeNode *pNode) {
+    if (!pNode || --pNode->refCount > 0) {
+        return;
+    }
+    
+    if (!isLeaf(pNode)) {
+        ropeRelease(pNode->pLeft);
+        ropeRelease(pNode->pRight);
+    }
+    free(pNode);
+}
+
+// Text is left uninitialized if pBytes is NULL
+static RopeNode *leafInit(const char *pBytes, int length) {
+    RopeNode *pNode = malloc(sizeof(RopeNode) + length);
+    if (!pNode) {
+        return NULL;
+    }
+    
+    pNode->refCount = 1;
+    pNode->length = length;
+    pNode->height = 0;
+    pNode->pLeft = NULL;
+    pNode->pRight = NULL;
+    if (pBytes && length > 0) {
+        memcpy(pNode->data, pBytes, length);
+    }
+    
+    return pNode;
+}
+
+// Consume both children, release them if memory is not enough
+static RopeNode *nodeInit(RopeNode *pLeft, RopeNode *pRight) {
+    RopeNode *pNode = malloc(sizeof(RopeNode));
+    if (!pNode) {
+        ropeRelease(pLeft);
+        ropeRelease(pRight);
+        return NULL;
+    }
+    
+    pNode->refCount = 1;
+    pNode->length = pLeft->length + pRight->length;
+    pNode->height = (pLeft->height > pRight->height ? pLeft->height : pRight->height) + 1;
+    pNode->pLeft = pLeft;
+    pNode->pRight = pRight;
+    
+    return pNode;
+}
+
+// Consume both subtrees, their heights differ by at most 2, rotate once or twice if needed
+static RopeNode *ropeBalance(RopeNode *pLeft, RopeNode *pRight) {
+    if (pLeft->height > pRight->height + 1) {
+        RopeNode *pLL = ropeRetain(pLeft->pLeft);
+        RopeNode *pLR = ropeRetain(pLeft->pRight);
+        ropeRelease(pLeft);
+    
+        if (pLL->height >= pLR->height) {
+            RopeNode *pInner = nodeInit(pLR, pRight);
+            if (!pInner) {
+                ropeRelease(pLL);
+                return NULL;
+            }
+            return nodeInit(pLL, pInner);
+        }
+    
+        RopeNode *pLRL = ropeRetain(pLR->pLeft);
+        RopeNode *pLRR = ropeRetain(pLR->pRight);
+        ropeRelease(pLR);
+    
+        RopeNode *pNewLeft = nodeInit(pLL, pLRL);
+        RopeNode *pNewRight = nodeInit(pLRR, pRight);
+        if (!pNewLeft || !pNewRight) {
+            ropeRelease(pNewLeft);
+            ropeRelease(pNewRight);
+            return NULL;
+        }
+        return nodeInit(pNewLeft, pNewRight);
+    }
+    
+    if (pRight->height > pLeft->height + 1) {
+        RopeNode *pRL = ropeRetain(pRight->pLeft);
+        RopeNode *pRR = ropeRetain(pRight->pRight);
+        ropeRelease(pRight);
+    
+        if (pRR->height >= pRL->height) {
+            RopeNode *pInner = nodeInit(pLeft, pRL);
+            if (!pInner) {
+                ropeRelease(pRR);
+                return NULL;
+            }
+            return nodeInit(pInner, pRR);
+        }
+    
+        RopeNode *pRLL = ropeRetain(pRL->pLeft);
+        RopeNode *pRLR = ropeRetain(pRL->pRight);
+        ropeRelease(pRL);
+    
+        RopeNode *pNewLeft = nodeInit(pLeft, pRLL);
+        RopeNode *pNewRight = nodeInit(pRLR, pRR);
+        if (!pNewLeft || !pNewRight) {
+            ropeRelease(pNewLeft);
+            ropeRelease(pNewRight);
+            return NULL;
+        }
+        return nodeInit(pNewLeft, pNewRight);
+    }
+    
+    return nodeInit(pLeft, pRight);
+}
+
+// Concatenate two trees, consume both, either may be NULL
+// Small adjacent leaves are merged, return false if memory is not enough
+static bool ropeJoin(RopeNode *pLeft, RopeNode *pRight, RopeNode **ppOut) {
+    if (!pLeft || !pRight) {
+        *ppOut = pLeft ? pLeft : pRight;
+        return true;
+    }
+    
+    if (isLeaf(pLeft) && isLeaf(pRight) && pLeft->length + pRight->length <= ROPE_LEAF_MAX) {
+        RopeNode *pLeaf = leafInit(NULL, pLeft->length + pRight->length);
+        if (pLeaf) {
+            memcpy(pLeaf->data, pLeft->data, pLeft->length);
+            memcpy(pLeaf->data + pLeft->length, pRight->data, pRight->length);
+        }
+        ropeRelease(pLeft);
+        ropeRelease(pRight);
+        *ppOut = pLeaf;
+        return pLeaf != NULL;
+    }
+    
+    if (pLeft->height > pRight->height) {
+        // Join along the right spine of the taller tree
+        RopeNode *pLL = ropeRetain(pLeft->pLeft);
+        RopeNode *pLR = ropeRetain(pLeft->pRight);
+        ropeRelease(pLeft);
+    
+        RopeNode *pJoined;
+        if (!ropeJoin(pLR, pRight, &pJoined)) {
+            ropeRelease(pLL);
+            return false;
+        }
+        *ppOut = ropeBalance(pLL, pJoined);
+        return *ppOut != NULL;
+    }
+    
+    if (pRight->height > pLeft->height) {
+        RopeNode *pRL = ropeRetain(pRight->pLeft);
+        RopeNode *pRR = ropeRetain(pRight->pRight);
+        ropeRelease(pRight);
+    
+        RopeNode *pJoined;
+        if (!ropeJoin(pLeft, pRL, &pJoined)) {
+            ropeRelease(pRR);
+            return false;
+        }
+        *ppOut = ropeBalance(pJoined, pRR);
+        return *ppOut != NULL;
+    }
+    
+    *ppOut = nodeInit(pLeft, pRight);
+    return *ppOut != NULL;
+}
+
+// Split pNode before index into two new references, pNode itself is kept
+// Return false if memory is not enough
+static bool ropeSplit(RopeNode *pNode, int index, RopeNode **ppLeft, RopeNode **ppRight) {
+    *ppLeft = NULL;
+    *ppRight = NULL;
+    
+    if (!pNode) {
+        return true;
+    }
+    if (index <= 0) {
+        *ppRight = ropeRetain(pNode);
+        return true;
+    }
+    if (index >= pNode->length) {
+        *ppLeft = ropeRetain(pNode);
+        return true;
+    }
+    
+    if (isLeaf(pNode)) {
+        *ppLeft = leafInit(pNode->data, index);
+        *ppRight = leafInit(pNode->data + index, pNode->length - index);
+        if (!*ppLeft || !*ppRight) {
+            ropeRelease(*ppLeft);
+            ropeRelease(*ppRight);
+            *ppLeft = *ppRight = NULL;
+            return false;
+        }
+        return true;
+    }
+    
+    int leftLength = pNode->pLeft->length;
+    if (index < leftLength) {
+        RopeNode *pRest;
+        if (!ropeSplit(pNode->pLeft, index, ppLeft, &pRest)) {
+            return false;
+        }
+        if (!ropeJoin(pRest, ropeRetain(pNode->pRight), ppRight)) {
+            ropeRelease(*ppLeft);
+            *ppLeft = NULL;
+            return false;
+        }
+        return true;
+    }
+    if (index > leftLength) {
+        RopeNode *pRest;
+        if (!ropeSplit(pNode->pRight, index - leftLength, &pRest, ppRight)) {
+            return false;
+        }
+        if (!ropeJoin(ropeRetain(pNode->pLeft), pRest, ppLeft)) {
+            ropeRelease(*ppRight);
+            *ppRight = NULL;
+            return false;
+        }
+        return true;
+    }
+    
+    *ppLeft = ropeRetain(pNode->pLeft);
+    *ppRight = ropeRetain(pNode->pRight);
+    return true;
+}
+
+// Build a balanced tree of full leaves, return false if memory is not enough
+static bool ropeBuild(const char *pBytes, int length, RopeNode **ppOut) {
+    *ppOut = NULL;
+    
+    if (length <= 0) {
+        return true;
+    }
+    if (length <= ROPE_LEAF_MAX) {
+        *ppOut = leafInit(pBytes, length);
+        return *ppOut != NULL;
+    }
+    
+    int leafCount = (length - 1) / ROPE_LEAF_MAX + 1;
+    int leftLength = leafCount / 2 * ROPE_LEAF_MAX;
+    
+    RopeNode *pLeft, *pRight;
+    if (!ropeBuild(pBytes, leftLength, &pLeft)) {
+        return false;
+    }
+    if (!ropeBuild(pBytes + leftLength, length - leftLength, &pRight)) {
+        ropeRelease(pLeft);
+        return false;
+    }
+    
+    *ppOut = nodeInit(pLeft, pRight);
+    return *ppOut != NULL;
+}
+
+static int nodeLength(const RopeNode *pNode) {
+    return pNode ? pNode->length : 0;
+}
+
+static bool isValidRange(const Rope *pRope, int start, int length) {
+    return start >= 0 && length >= 0 && start <= nodeLength(pRope->pRoot) && length <= nodeLength(pRope->pRoot) - start;
+}
+
+// Return the leaf containing index, and the offset of index in it
+static const RopeNode *leafIteratorStart(RopeLeafIterator *pIter, const RopeNode *pNode, int index, int *pOffset) {
+    pIter->depth = 0;
+    
+    if (!pNode || index >= pNode->length) {
+        return NULL;
+    }
+    
+    while (!isLeaf(pNode)) {
+        if (index < pNode->pLeft->length) {
+            pIter->stack[pIter->depth++] = pNode->pRight;
+            pNode = pNode->pLeft;
+        } else {
+            index -= pNode->pLeft->length;
+            pNode = pNode->pRight;
+        }
+    }
+    
+    *pOffset = index;
+    return pNode;
+}
+
+// Return NULL after the last leaf
+static const RopeNode *leafIteratorNext(RopeLeafIterator *pIter) {
+    if (!pIter->depth) {
+        return NULL;
+    }
+    
+    const RopeNode *pNode = pIter->stack[--pIter->depth];
+    while (!isLeaf(pNode)) {
+        pIter->stack[pIter->depth++] = pNode->pRight;
+        pNode = pNode->pLeft;
+    }
+    
+    return pNode;
+}
+
+// Copy length bytes from index start to pOut
+static void ropeCopyBytes(const RopeNode *pRoot, int start, int length, char *pOut) {
+    RopeLeafIterator iter;
+    int offset = 0;
+    for (const RopeNode *pLeaf = leafIteratorStart(&iter, pRoot, start, &offset); pLeaf && length > 0; pLeaf = leafIteratorNext(&iter)) {
+        int count = pLeaf->length - offset;
+        if (count > length) {
+            count = length;
+        }
+        memcpy(pOut, pLeaf->data + offset, count);
+        pOut += count;
+        length -= count;
+        offset = 0;
+    }
+}
+
+// Insert a tree before index, consume pNew
+static bool ropeInsertNode(Rope *pRope, int index, RopeNode *pNew) {
+    RopeNode *pLeft, *pRight, *pJoined, *pRoot;
+    
+    if (!ropeSplit(pRope->pRoot, index, &pLeft, &pRight)) {
+        ropeRelease(pNew);
+        return false;
+    }
+    if (!ropeJoin(pLeft, pNew, &pJoined)) {
+        ropeRelease(pRight);
+        return false;
+    }
+    if (!ropeJoin(pJoined, pRight, &pRoot)) {
+        return false;
+    }
+    
+    ropeRelease(pRope->pRoot);
+    pRope->pRoot = pRoot;
+    
+    return true;
+}
+
+// Cut the range out, return the tree of the range through ppRange if it is not NULL
+static bool ropeCut(Rope *pRope, int start, int length, RopeNode **ppRange) {
+    RopeNode *pLeft, *pRest, *pRange, *pRight, *pRoot;
+    
+    if (!ropeSplit(pRope->pRoot, start, &pLeft, &pRest)) {
+        return false;
+    }
+    bool isSplit = ropeSplit(pRest, length, &pRange, &pRight);
+    ropeRelease(pRest);
+    if (!isSplit) {
+        ropeRelease(pLeft);
+        return false;
+    }
+    if (!ropeJoin(pLeft, pRight, &pRoot)) {
+        ropeRelease(pRange);
+        return false;
+    }
+    
+    ropeRelease(pRope->pRoot);
+    pRope->pRoot = pRoot;
+    
+    if (ppRange) {
+        *ppRange = pRange;
+    } else {
+        ropeRelease(pRange);
+    }
+    
+    return true;
+}
+
+#pragma mark - Make Rope
+
+Rope *RopeInit() {
+    Rope *pRope = malloc(sizeof(Rope));
+    if (!pRope) {
+        return NULL;
+    }
+    
+    pRope->pRoot = NULL;
+    
+    return pRope;
+}
+
+Rope *RopeInitWithString(const String *pStr) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    return RopeInitWithBytes(pStr->pData, pStr->length);
+}
+
+Rope *RopeInitWithCString(const char *pCStr) {
+    if (!pCStr) {
+        return NULL;
+    }
+    
+    size_t length = strlen(pCStr);
+    if (length > INT_MAX) {
+        return NULL;
+    }
+    
+    return RopeInitWithBytes(pCStr, (int)length);
+}
+
+Rope *RopeInitWithBytes(const char *pBytes, int length) {
+    if (length < 0 || (!pBytes && length > 0)) {
+        return NULL;
+    }
+    
+    Rope *pRope = RopeInit();
+    if (!pRope) {
+        return NULL;
+    }
+    
+    if (!ropeBuild(pBytes, length, &pRope->pRoot)) {
+        free(pRope);
+        return NULL;
+    }
+    
+    return pRope;
+}
+
+// O(1), the copy shares all chunks with pRope
+Rope *RopeCopy(const Rope *pRope) {
+    if (!pRope) {
+        return NULL;
+    }
+    
+    Rope *pCopy = RopeInit();
+    if (!pCopy) {
+        return NULL;
+    }
+    
+    pCopy->pRoot = ropeRetain(pRope->pRoot);
+    
+    return pCopy;
+}
+
+// O(log n), the sub-rope shares chunks with pRope
+Rope *RopeSubRope(const Rope *pRope, int start, int length) {
+    if (!pRope || !isValidRange(pRope, start, length)) {
+        return NULL;
+    }
+    
+    Rope *pSub = RopeInit();
+    if (!pSub) {
+        return NULL;
+    }
+    
+    RopeNode *pLeft, *pRest, *pRight;
+    if (!ropeSplit(pRope->pRoot, start, &pLeft, &pRest)) {
+        free(pSub);
+        return NULL;
+    }
+    ropeRelease(pLeft);
+    
+    bool isSplit = ropeSplit(pRest, length, &pSub->pRoot, &pRight);
+    ropeRelease(pRest);
+    ropeRelease(pRight);
+    if (!isSplit) {
+        free(pSub);
+        return NULL;
+    }
+    
+    return pSub;
+}
+
+void RopeDestroy(Rope *pRope) {
+    if (!pRope) {
+        return;
+    }
+    
+    ropeRelease(pRope->pRoot);
+    free(pRope);
+}
+
+String *RopeToString(const Rope *pRope) {
+    if (!pRope) {
+        return NULL;
+    }
+    
+    return RopeSubString(pRope, 0, nodeLength(pRope->pRoot));
+}
+
+String *RopeSubString(const Rope *pRope, int start, int length) {
+    if (!pRope || !isValidRange(pRope, start, length)) {
+        return NULL;
+    }
+    
+    String *pStr = StringInit();
+    if (!pStr) {
+        return NULL;
+    }
+    // One more for the '\0' StringCStringView writes
+    if (length == INT_MAX || !ArrayReserve(pStr, length + 1)) {
+        StringDestroy(pStr);
+        return NULL;
+    }
+    
+    RopeLeafIterator iter;
+    int offset = 0;
+    for (const RopeNode *pLeaf = leafIteratorStart(&iter, pRope->pRoot, start, &offset); pLeaf && length > 0; pLeaf = leafIteratorNext(&iter)) {
+        int count = pLeaf->length - offset;
+        if (count > length) {
+            count = length;
+        }
+        // Capacity is reserved, appending can't fail
+        StringAppendBytes(pStr, pLeaf->data + offset, count);
+        length -= count;
+        offset = 0;
+    }
+    
+    return pStr;
+}
+
+char *RopeCString(const Rope *pRope) {
+    if (!pRope) {
+        return NULL;
+    }
+    
+    int length = nodeLength(pRope->pRoot);
+    char *pCStr = malloc(length + 1);
+    if (!pCStr) {
+        return NULL;
+    }
+    
+    ropeCopyBytes(pRope->pRoot, 0, length, pCStr);
+    pCStr[length] = '\0';
+    
+    return pCStr;
+}
+
+#pragma mark - Get Properties
+
+int RopeLength(const Rope *pRope) {
+    return pRope ? nodeLength(pRope->pRoot) : 0;
+}
+
+// Return '\0' if parameters invalid
+char RopeCharacter(const Rope *pRope, int index) {
+    char ch = '\0';
+    RopeGetCharacter(pRope, index, &ch);
+    
+    return ch;
+}
+
+bool RopeGetCharacter(const Rope *pRope, int index, char *pOut) {
+    if (!pRope || !pOut || index < 0 || index >= nodeLength(pRope->pRoot)) {
+        return false;
+    }
+    
+    const RopeNode *pNode = pRope->pRoot;
+    while (!isLeaf(pNode)) {
+        if (index < pNode->pLeft->length) {
+            pNode = pNode->pLeft;
+        } else {
+            index -= pNode->pLeft->length;
+            pNode = pNode->pRight;
+        }
+    }
+    
+    *pOut = pNode->data[index];
+    
+    return true;
+}
+
+#pragma mark - Operation
+
+void RopeClear(Rope *pRope) {
+    if (!pRope) {
+        return;
+    }
+    
+    ropeRelease(pRope->pRoot);
+    pRope->pRoot = NULL;
+}
+
+// pFunc gets a copy of each character, changes are not written back
+void RopeTraverse(const Rope *pRope, void (*pFunc)(void *)) {
+    if (!pRope || !pFunc) {
+        return;
+    }
+    
+    RopeLeafIterator iter;
+    int offset = 0;
+    for (const RopeNode *pLeaf = leafIteratorStart(&iter, pRope->pRoot, 0, &offset); pLeaf; pLeaf = leafIteratorNext(&iter)) {
+        for (int i = 0; i < pLeaf->length; i++) {
+            char ch = pLeaf->data[i];
+            pFunc(&ch);
+        }
+    }
+}
+
+// Call pFunc with each chunk in order, stop early if pFunc returns false
+void RopeTraverseChunks(const Rope *pRope, bool (*pFunc)(const char *pData, int length, void *pContext), void *pContext) {
+    if (!pRope || !pFunc) {
+        return;
+    }
+    
+    RopeLeafIterator iter;
+    int offset = 0;
+    for (const RopeNode *pLeaf = leafIteratorStart(&iter, pRope->pRoot, 0, &offset); pLeaf; pLeaf = leafIteratorNext(&iter)) {
+        if (!pFunc(pLeaf->data, pLeaf->length, pContext)) {
+            return;
+        }
+    }
+}
+
+// Search from index start, return -1 if no such character, return -2 if parameters invalid
+int  RopeFindCharacter(const Rope *pRope, char ch, int start) {
+    if (!pRope || start < 0 || start > nodeLength(pRope->pRoot)) {
+        return -2;
+    }
+    
+    RopeLeafIterator iter;
+    int offset = 0;
+    int leafStart = start;
+    for (const RopeNode *pLeaf = leafIteratorStart(&iter, pRope->pRoot, start, &offset); pLeaf; pLeaf = leafIteratorNext(&iter)) {
+        const char *pFound = memchr(pLeaf->data + offset, ch, pLeaf->length - offset);
+        if (pFound) {
+            return leafStart + (int)(pFound - (pLeaf->data + offset));
+        }
+        leafStart += pLeaf->length - offset;
+        offset = 0;
+    }
+    
+    return -1;
+}
+
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int  RopeFindSubString(const Rope *pRope, const String *pSub, int start) {
+    if (!pSub) {
+        return -2;
+    }
+    
+    const char *pSubData = pSub->pData;
+    int subLength = pSub->length;
+    if (!pRope || start < 0 || start > nodeLength(pRope->pRoot)) {
+        return -2;
+    }
+    if (subLength == 0) {
+        return start;
+    }
+    if (subLength == 1) {
+        return RopeFindCharacter(pRope, pSubData[0], start);
+    }
+    
+    StringSearcher *pSearcher = StringSearcherInit(pSub);
+    // The last subLength - 1 bytes of the text searched so far are carried in front of the next chunk
+    char *pWindow = malloc(subLength - 1 + ROPE_LEAF_MAX);
+    if (!pSearcher || !pWindow) {
+        StringSearcherDestroy(pSearcher);
+        free(pWindow);
+        return -2;
+    }
+    
+    int result = -1;
+    int windowStart = start;
+    int carried = 0;
+    
+    RopeLeafIterator iter;
+    int offset = 0;
+    for (const RopeNode *pLeaf = leafIteratorStart(&iter, pRope->pRoot, start, &offset); pLeaf; pLeaf = leafIteratorNext(&iter)) {
+        int count = pLeaf->length - offset;
+        memcpy(pWindow + carried, pLeaf->data + offset, count);
+        int windowLength = carried + count;
+        offset = 0;
+    
+        int index = StringSearcherFindInBytes(pSearcher, pWindow, windowLength, 0);
+        if (index >= 0) {
+            result = windowStart + index;
+            break;
+        }
+    
+        carried = windowLength < subLength - 1 ? windowLength : subLength - 1;
+        memmove(pWindow, pWindow + windowLength - carried, carried);
+        windowStart += windowLength - carried;
+    }
+    
+    StringSearcherDestroy(pSearcher);
+    free(pWindow);
+    
+    return result;
+}
+
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int  RopeFindSubCString(const Rope *pRope, const char *pCSub, int start) {
+    String *pSub = StringInitWithCString(pCSub);
+    if (!pSub) {
+        return -2;
+    }
+    
+    int result = RopeFindSubString(pRope, pSub, start);
+    
+    StringDestroy(pSub);
+    
+    return result;
+}
+
+// Accept only non-NULL parameters (Return 0 if any parameter is invalid)
+int  RopeCompare(const Rope *pRopeA, const Rope *pRopeB) {
+    if (!pRopeA || !pRopeB) {
+        return 0;
+    }
+    
+    RopeLeafIterator iterA, iterB;
+    int offsetA = 0, offsetB = 0;
+    const RopeNode *pLeafA = leafIteratorStart(&iterA, pRopeA->pRoot, 0, &offsetA);
+    const RopeNode *pLeafB = leafIteratorStart(&iterB, pRopeB->pRoot, 0, &offsetB);
+    
+    while (pLeafA && pLeafB) {
+        int count = pLeafA->length - offsetA;
+        if (count > pLeafB->length - offsetB) {
+            count = pLeafB->length - offsetB;
+        }
+    
+        int result = memcmp(pLeafA->data + offsetA, pLeafB->data + offsetB, count);
+        if (result) {
+            return result > 0 ? 1 : -1;
+        }
+    
+        offsetA += count;
+        offsetB += count;
+        if (offsetA == pLeafA->length) {
+            pLeafA = leafIteratorNext(&iterA);
+            offsetA = 0;
+        }
+        if (offsetB == pLeafB->length) {
+            pLeafB = leafIteratorNext(&iterB);
+            offsetB = 0;
+        }
+    }
+    
+    return pLeafA ? 1 : (pLeafB ? -1 : 0);
+}
+
+#pragma mark - Edit
+
+#pragma mark ---Insert
+
+bool RopeInsertString(Rope *pRope, int index, const String *pStr) {
+    if (!pStr) {
+        return false;
+    }
+    
+    return RopeInsertBytes(pRope, index, pStr->pData, pStr->length);
+}
+
+bool RopeInsertCString(Rope *pRope, int index, const char *pCStr) {
+    if (!pCStr) {
+        return false;
+    }
+    
+    size_t length = strlen(pCStr);
+    if (length > INT_MAX) {
+        return false;
+    }
+    
+    return RopeInsertBytes(pRope, index, pCStr, (int)length);
+}
+
+bool RopeInsertBytes(Rope *pRope, int index, const char *pBytes, int length) {
+    if (!pRope || length < 0 || (!pBytes && length > 0)) {
+        return false;
+    }
+    if (index < 0 || index > nodeLength(pRope->pRoot) || length > INT_MAX - nodeLength(pRope->pRoot)) {
+        return false;
+    }
+    
+    RopeNode *pNew;
+    if (!ropeBuild(pBytes, length, &pNew)) {
+        return false;
+    }
+    
+    return ropeInsertNode(pRope, index, pNew);
+}
+
+// O(log n), pRope shares chunks with pOther
+bool RopeInsertRope(Rope *pRope, int index, const Rope *pOther) {
+    if (!pRope || !pOther) {
+        return false;
+    }
+    if (index < 0 || index > nodeLength(pRope->pRoot) || nodeLength(pOther->pRoot) > INT_MAX - nodeLength(pRope->pRoot)) {
+        return false;
+    }
+    
+    return ropeInsertNode(pRope, index, ropeRetain(pOther->pRoot));
+}
+
+bool RopeAppendString(Rope *pRope, const String *pStr) {
+    return RopeInsertString(pRope, RopeLength(pRope), pStr);
+}
+
+bool RopeAppendCString(Rope *pRope, const char *pCStr) {
+    return RopeInsertCString(pRope, RopeLength(pRope), pCStr);
+}
+
+// O(log n), pRope shares chunks with pOther
+bool RopeAppendRope(Rope *pRope, const Rope *pOther) {
+    return RopeInsertRope(pRope, RopeLength(pRope), pOther);
+}
+
+bool RopePrependString(Rope *pRope, const String *pStr) {
+    return RopeInsertString(pRope, 0, pStr);
+}
+
+bool RopePrependCString(Rope *pRope, const char *pCStr) {
+    return RopeInsertCString(pRope, 0, pCStr);
+}
+
+#pragma mark ---Delete
+
+bool RopeDeleteSubString(Rope *pRope, int start, int length) {
+    if (!pRope || !isValidRange(pRope, start, length)) {
+        return false;
+    }
+    
+    return ropeCut(pRope, start, length, NULL);
+}
+
+#pragma mark ---Replace
+
+bool RopeReplaceSubString(Rope *pRope, int start, int length, const String *pNew) {
+    if (!pRope || !pNew || !isValidRange(pRope, start, length)) {
+        return false;
+    }
+    if (pNew->length > INT_MAX - (nodeLength(pRope->pRoot) - length)) {
+        return false;
+    }
+    
+    RopeNode *pNewNode;
+    if (!ropeBuild(pNew->pData, pNew->length, &pNewNode)) {
+        return false;
+    }
+    
+    RopeNode *pOldRoot = ropeRetain(pRope->pRoot);
+    if (!ropeCut(pRope, start, length, NULL)) {
+        ropeRelease(pOldRoot);
+        ropeRelease(pNewNode);
+        return false;
+    }
+    if (!ropeInsertNode(pRope, start, pNewNode)) {
+        // Put the old text back
+        ropeRelease(pRope->pRoot);
+        pRope->pRoot = pOldRoot;
+        return false;
+    }
+    
+    ropeRelease(pOldRoot);
+    
+    return true;
+}
+
+bool RopeReplaceSubCString(Rope *pRope, int start, int length, const char *pCNew) {
+    String *pNew = StringInitWithCString(pCNew);
+    if (!pNew) {
+        return false;
+    }
+    
+    bool result = RopeReplaceSubString(pRope, start, length, pNew);
+    
+    StringDestroy(pNew);
+    
+    return result;
+}
@@ -0,0 +1,82 @@
+//
+//  Rope.h
+//  DataStructure
+//
+
+#ifndef __Rope__
+#define __Rope__
+
+#include <stdio.h>
+#include "String.h"
+
+// Balanced tree of text chunks for large, heavily edited text.
+// Index, insert, delete and sub-rope are O(log n), copy is O(1),
+// ropes share unchanged chunks with the ropes they are made from.
+
+#pragma mark - Type Definition
+
+typedef struct _rope Rope;
+
+#pragma mark - Make Rope
+
+Rope *RopeInit();
+Rope *RopeInitWithString(const String *pStr);
+Rope *RopeInitWithCString(const char *pCStr);
+Rope *RopeInitWithBytes(const char *pBytes, int length);
+// O(1), the copy shares all chunks with pRope
+Rope *RopeCopy(const Rope *pRope);
+// O(log n), the sub-rope shares chunks with pRope
+Rope *RopeSubRope(const Rope *pRope, int start, int length);
+void RopeDestroy(Rope *pRope);
+
+String *RopeToString(const Rope *pRope);
+String *RopeSubString(const Rope *pRope, int start, int length);
+char *RopeCString(const Rope *pRope);
+
+#pragma mark - Get Properties
+
+int RopeLength(const Rope *pRope);
+// Return '\0' if parameters invalid
+char RopeCharacter(const Rope *pRope, int index);
+bool RopeGetCharacter(const Rope *pRope, int index, char *pOut);
+
+#pragma mark - Operation
+
+void RopeClear(Rope *pRope);
+// pFunc gets a copy of each character, changes are not written back
+void RopeTraverse(const Rope *pRope, void (*pFunc)(void *));
+// Call pFunc with each chunk in order, stop early if pFunc returns false
+void RopeTraverseChunks(const Rope *pRope, bool (*pFunc)(const char *pData, int length, void *pContext), void *pContext);
+
+// Search from index start, return -1 if no such character, return -2 if parameters invalid
+int  RopeFindCharacter(const Rope *pRope, char ch, int start);
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int  RopeFindSubString(const Rope *pRope, const String *pSub, int start);
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int  RopeFindSubCString(const Rope *pRope, const char *pCSub, int start);
+// Accept only non-NULL parameters (Return 0 if any parameter is invalid)
+int  RopeCompare(const Rope *pRopeA, const Rope *pRopeB);
+
+#pragma mark - Edit
+
+#pragma mark ---Insert
+bool RopeInsertString(Rope *pRope, int index, const String *pStr);
+bool RopeInsertCString(Rope *pRope, int index, const char *pCStr);
+bool RopeInsertBytes(Rope *pRope, int index, const char *pBytes, int length);
+// O(log n), pRope shares chunks with pOther
+bool RopeInsertRope(Rope *pRope, int index, const Rope *pOther);
+bool RopeAppendString(Rope *pRope, const String *pStr);
+bool RopeAppendCString(Rope *pRope, const char *pCStr);
+// O(log n), pRope shares chunks with pOther
+bool RopeAppendRope(Rope *pRope, const Rope *pOther);
+bool RopePrependString(Rope *pRope, const String *pStr);
+bool RopePrependCString(Rope *pRope, const char *pCStr);
+
+#pragma mark ---Delete
+bool RopeDeleteSubString(Rope *pRope, int start, int length);
+
+#pragma mark ---Replace
+bool RopeReplaceSubString(Rope *pRope, int start, int length, const String *pNew);
+bool RopeReplaceSubCString(Rope *pRope, int start, int length, const char *pCNew);
+
+#endif
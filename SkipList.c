@@ -0,0 +1,439 @@
+//
+//  SkipList.c
+//  DataStructure
+//
+
+#include "SkipList.h"
+
+#pragma mark - Skip List Structure
+
+#define SKIP_LIST_MAX_LEVEL 32
+
+typedef struct _skip_list_node SkipListNode;
+
+typedef struct _skip_list_link {
+    SkipListNode *pNext;
+    // Count of positions from this node to pNext (to the end position if pNext is NULL)
+    int width;
+} SkipListLink;
+
+struct _skip_list_node {
+    int level;
+    // level links followed by the item
+    SkipListLink links[];
+};
+
+struct _skip_list {
+    SkipListNode *pHead;
+    int itemSize;
+    int length;
+    int level;
+    unsigned int seed;
+    int (*pCompareFunc)(const void *, const void *);
+};
+
+#pragma mark - Inner Function
+
+static void *slItemOf(const SkipListNode *pNode) {
+    return (void *)(pNode->links + pNode->level);
+}
+
+static SkipListNode *slNodeInit(int level, int itemSize) {
+    SkipListNode *pNode = malloc(sizeof(SkipListNode) + level * sizeof(SkipListLink) + itemSize);
+    if (!pNode) {
+        return NULL;
+    }
+    
+    pNode->level = level;
+    
+    return pNode;
+}
+
+// Each level holds about a quarter of the nodes of the level below
+static int slRandomLevel(SkipList *pList) {
+    // xorshift32
+    unsigned int x = pList->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pList->seed = x;
+    
+    int level = 1;
+    while ((x & 3) == 0 && level < SKIP_LIST_MAX_LEVEL) {
+        level++;
+        x >>= 2;
+    }
+    
+    return level;
+}
+
+// Return the node at index (0 based), index should be in range
+static SkipListNode *slNodeAt(const SkipList *pList, int index) {
+    SkipListNode *pNode = pList->pHead;
+    int position = 0; // The head is at position 0, the item at index i is at position i + 1
+    
+    for (int lvl = pList->level - 1; lvl >= 0; lvl--) {
+        while (pNode->links[lvl].pNext && position + pNode->links[lvl].width <= index + 1) {
+            position += pNode->links[lvl].width;
+            pNode = pNode->links[lvl].pNext;
+        }
+    }
+    
+    return pNode;
+}
+
+// Fill pUpdate with the last node before index on each level, and pRank with their positions
+static void slFindUpdate(const SkipList *pList, int index, SkipListNode **pUpdate, int *pRank) {
+    SkipListNode *pNode = pList->pHead;
+    int position = 0;
+    
+    for (int lvl = SKIP_LIST_MAX_LEVEL - 1; lvl >= 0; lvl--) {
+        while (pNode->links[lvl].pNext && position + pNode->links[lvl].width <= index) {
+            position += pNode->links[lvl].width;
+            pNode = pNode->links[lvl].pNext;
+        }
+        pUpdate[lvl] = pNode;
+        pRank[lvl] = position;
+    }
+}
+
+// Return the count of items less than pVal, or not greater than pVal if inclusive
+static int slRankOf(const SkipList *pList, const void *pVal, bool inclusive, SkipListNode **ppNode) {
+    SkipListNode *pNode = pList->pHead;
+    int position = 0;
+    
+    for (int lvl = pList->level - 1; lvl >= 0; lvl--) {
+        while (pNode->links[lvl].pNext) {
+            int result = pList->pCompareFunc(slItemOf(pNode->links[lvl].pNext), pVal);
+            if (result > 0 || (result == 0 && !inclusive)) {
+                break;
+            }
+            position += pNode->links[lvl].width;
+            pNode = pNode->links[lvl].pNext;
+        }
+    }
+    
+    if (ppNode) {
+        *ppNode = pNode;
+    }
+    
+    return position;
+}
+
+#pragma mark - Make List
+
+SkipList *SkipListInit(int itemSize) {
+    return SkipListInitWithCompareFunc(itemSize, NULL);
+}
+
+SkipList *SkipListInitWithCompareFunc(int itemSize, int (*pCompareFunc)(const void *, const void *)) {
+    if (itemSize <= 0) {
+        return NULL;
+    }
+    
+    SkipList *pList = malloc(sizeof(SkipList));
+    if (!pList) {
+        return NULL;
+    }
+    
+    pList->pHead = slNodeInit(SKIP_LIST_MAX_LEVEL, 0);
+    if (!pList->pHead) {
+        free(pList);
+        return NULL;
+    }
+    
+    for (int lvl = 0; lvl < SKIP_LIST_MAX_LEVEL; lvl++) {
+        pList->pHead->links[lvl].pNext = NULL;
+        pList->pHead->links[lvl].width = 1;
+    }
+    
+    pList->itemSize = itemSize;
+    pList->length = 0;
+    pList->level = 1;
+    pList->seed = 2463534242u;
+    pList->pCompareFunc = pCompareFunc;
+    
+    return pList;
+}
+
+SkipList *SkipListCopy(const SkipList *pList) {
+    if (!pList) {
+        return NULL;
+    }
+    
+    SkipList *pOut = SkipListInitWithCompareFunc(pList->itemSize, pList->pCompareFunc);
+    if (!pOut) {
+        return NULL;
+    }
+    
+    for (SkipListNode *pNode = pList->pHead->links[0].pNext; pNode; pNode = pNode->links[0].pNext) {
+        if (!SkipListAppendItem(pOut, slItemOf(pNode))) {
+            SkipListDestroy(pOut);
+            return NULL;
+        }
+    }
+    
+    return pOut;
+}
+
+#pragma mark - Get Properties
+
+int SkipListLength(const SkipList *pList) {
+    return pList ? pList->length : -1;
+}
+
+int SkipListItemSize(const SkipList *pList) {
+    return pList ? pList->itemSize : -1;
+}
+
+#pragma mark - Manipulate Whole List
+
+void SkipListDestroy(SkipList *pList) {
+    if (!pList) {
+        return;
+    }
+    
+    SkipListClear(pList);
+    free(pList->pHead);
+    free(pList);
+}
+
+void SkipListClear(SkipList *pList) {
+    if (!pList) {
+        return;
+    }
+    
+    SkipListNode *pNode = pList->pHead->links[0].pNext;
+    while (pNode) {
+        SkipListNode *pNext = pNode->links[0].pNext;
+        free(pNode);
+        pNode = pNext;
+    }
+    
+    for (int lvl = 0; lvl < SKIP_LIST_MAX_LEVEL; lvl++) {
+        pList->pHead->links[lvl].pNext = NULL;
+        pList->pHead->links[lvl].width = 1;
+    }
+    pList->length = 0;
+    pList->level = 1;
+}
+
+void SkipListTraverse(SkipList *pList, void (*pFunc)(void *)) {
+    if (!pList || !pFunc) {
+        return;
+    }
+    
+    for (SkipListNode *pNode = pList->pHead->links[0].pNext; pNode; pNode = pNode->links[0].pNext) {
+        pFunc(slItemOf(pNode));
+    }
+}
+
+#pragma mark - Manipulate Single Item
+
+bool SkipListGetItem(const SkipList *pList, int index, void *pOut) {
+    if (!pList || !pOut) {
+        return false;
+    }
+    
+    if (index < 0 || index >= pList->length) {
+        return false;
+    }
+    
+    memcpy(pOut, slItemOf(slNodeAt(pList, index)), pList->itemSize);
+    
+    return true;
+}
+
+bool SkipListGetHeadItem(const SkipList *pList, void *pOut) {
+    return SkipListGetItem(pList, 0, pOut);
+}
+
+bool SkipListGetTailItem(const SkipList *pList, void *pOut) {
+    return SkipListGetItem(pList, pList->length - 1, pOut);
+}
+
+bool SkipListSetItem(SkipList *pList, int index, const void *pIn) {
+    if (!pList || !pIn) {
+        return false;
+    }
+    
+    if (index < 0 || index >= pList->length) {
+        return false;
+    }
+    
+    memcpy(slItemOf(slNodeAt(pList, index)), pIn, pList->itemSize);
+    
+    return true;
+}
+
+// Accept index range from 0 to pList->length
+bool SkipListInsertItem(SkipList *pList, int index, const void *pIn) {
+    if (!pList || !pIn) {
+        return false;
+    }
+    
+    if (index < 0 || index > pList->length) {
+        return false;
+    }
+    
+    int level = slRandomLevel(pList);
+    SkipListNode *pNode = slNodeInit(level, pList->itemSize);
+    if (!pNode) {
+        return false;
+    }
+    
+    memcpy(slItemOf(pNode), pIn, pList->itemSize);
+    
+    SkipListNode *pUpdate[SKIP_LIST_MAX_LEVEL];
+    int rank[SKIP_LIST_MAX_LEVEL];
+    slFindUpdate(pList, index, pUpdate, rank);
+    
+    // The new node takes position index + 1
+    for (int lvl = 0; lvl < SKIP_LIST_MAX_LEVEL; lvl++) {
+        SkipListLink *pLink = &pUpdate[lvl]->links[lvl];
+        if (lvl < level) {
+            pNode->links[lvl].pNext = pLink->pNext;
+            pNode->links[lvl].width = rank[lvl] + pLink->width - index;
+            pLink->pNext = pNode;
+            pLink->width = index + 1 - rank[lvl];
+        } else {
+            pLink->width++;
+        }
+    }
+    
+    if (level > pList->level) {
+        pList->level = level;
+    }
+    pList->length++;
+    
+    return true;
+}
+
+bool SkipListAppendItem(SkipList *pList, const void *pIn) {
+    return SkipListInsertItem(pList, pList->length, pIn);
+}
+
+bool SkipListPrependItem(SkipList *pList, const void *pIn) {
+    return SkipListInsertItem(pList, 0, pIn);
+}
+
+bool SkipListDeleteItem(SkipList *pList, int index) {
+    if (!pList) {
+        return false;
+    }
+    
+    if (index < 0 || index >= pList->length) {
+        return false;
+    }
+    
+    SkipListNode *pUpdate[SKIP_LIST_MAX_LEVEL];
+    int rank[SKIP_LIST_MAX_LEVEL];
+    slFindUpdate(pList, index, pUpdate, rank);
+    
+    SkipListNode *pNode = pUpdate[0]->links[0].pNext;
+    for (int lvl = 0; lvl < SKIP_LIST_MAX_LEVEL; lvl++) {
+        SkipListLink *pLink = &pUpdate[lvl]->links[lvl];
+        if (lvl < pNode->level) {
+            pLink->pNext = pNode->links[lvl].pNext;
+            pLink->width += pNode->links[lvl].width - 1;
+        } else {
+            pLink->width--;
+        }
+    }
+    
+    free(pNode);
+    
+    while (pList->level > 1 && !pList->pHead->links[pList->level - 1].pNext) {
+        pList->level--;
+    }
+    pList->length--;
+    
+    return true;
+}
+
+bool SkipListDeleteHeadItem(SkipList *pList) {
+    return SkipListDeleteItem(pList, 0);
+}
+
+bool SkipListDeleteTailItem(SkipList *pList) {
+    return SkipListDeleteItem(pList, pList->length - 1);
+}
+
+#pragma mark - Ordered Set
+
+// Insert after the equal items, return the index of the new item, return -1 if failed, return -2 if parameters invalid
+int SkipListAddItem(SkipList *pList, const void *pIn) {
+    if (!pList || !pIn || !pList->pCompareFunc) {
+        return -2;
+    }
+    
+    int index = slRankOf(pList, pIn, true, NULL);
+    
+    return SkipListInsertItem(pList, index, pIn) ? index : -1;
+}
+
+// Delete the first equal item, return false if no such item
+bool SkipListRemoveItem(SkipList *pList, const void *pVal) {
+    int index = SkipListFind(pList, pVal);
+    if (index < 0) {
+        return false;
+    }
+    
+    return SkipListDeleteItem(pList, index);
+}
+
+// Return index of the first equal item, return -1 if no such item, return -2 if parameters invalid
+int SkipListFind(const SkipList *pList, const void *pVal) {
+    if (!pList || !pVal || !pList->pCompareFunc) {
+        return -2;
+    }
+    
+    SkipListNode *pNode = NULL;
+    int index = slRankOf(pList, pVal, false, &pNode);
+    pNode = pNode->links[0].pNext;
+    
+    if (!pNode || 0 != pList->pCompareFunc(slItemOf(pNode), pVal)) {
+        return -1;
+    }
+    
+    return index;
+}
+
+// Return index of the first item not less than pVal (pList->length if none), return -2 if parameters invalid
+int SkipListLowerBound(const SkipList *pList, const void *pVal) {
+    if (!pList || !pVal || !pList->pCompareFunc) {
+        return -2;
+    }
+    
+    return slRankOf(pList, pVal, false, NULL);
+}
+
+// Return index of the first item greater than pVal (pList->length if none), return -2 if parameters invalid
+int SkipListUpperBound(const SkipList *pList, const void *pVal) {
+    if (!pList || !pVal || !pList->pCompareFunc) {
+        return -2;
+    }
+    
+    return slRankOf(pList, pVal, true, NULL);
+}
+
+// Call pFunc on every item in range [pLow, pHigh), return the count of them, return -2 if parameters invalid
+int SkipListTraverseRange(SkipList *pList, const void *pLow, const void *pHigh, void (*pFunc)(void *)) {
+    if (!pList || !pLow || !pHigh || !pFunc || !pList->pCompareFunc) {
+        return -2;
+    }
+    
+    SkipListNode *pNode = NULL;
+    slRankOf(pList, pLow, false, &pNode);
+    
+    int count = 0;
+    for (pNode = pNode->links[0].pNext; pNode; pNode = pNode->links[0].pNext) {
+        if (pList->pCompareFunc(slItemOf(pNode), pHigh) >= 0) {
+            break;
+        }
+        pFunc(slItemOf(pNode));
+        count++;
+    }
+    
+    return count;
+}
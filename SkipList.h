@@ -0,0 +1,69 @@
+//
+//  SkipList.h
+//  DataStructure
+//
+
+#ifndef __SkipList__
+#define __SkipList__
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Type Definition
+
+// Indexable skip list, positional access, insert and delete are all O(log n)
+typedef struct _skip_list SkipList;
+
+#pragma mark - Make List
+
+SkipList *SkipListInit(int itemSize);
+// Needed by the ordered set functions
+SkipList *SkipListInitWithCompareFunc(int itemSize, int (*pCompareFunc)(const void *, const void *));
+SkipList *SkipListCopy(const SkipList *pList);
+
+#pragma mark - Get Properties
+
+int SkipListLength(const SkipList *pList);
+int SkipListItemSize(const SkipList *pList);
+
+#pragma mark - Manipulate Whole List
+
+void SkipListDestroy(SkipList *pList);
+void SkipListClear(SkipList *pList);
+void SkipListTraverse(SkipList *pList, void (*pFunc)(void *));
+
+#pragma mark - Manipulate Single Item
+
+bool SkipListGetItem(const SkipList *pList, int index, void *pOut);
+bool SkipListGetHeadItem(const SkipList *pList, void *pOut);
+bool SkipListGetTailItem(const SkipList *pList, void *pOut);
+bool SkipListSetItem(SkipList *pList, int index, const void *pIn);
+// Accept index range from 0 to pList->length
+bool SkipListInsertItem(SkipList *pList, int index, const void *pIn);
+bool SkipListAppendItem(SkipList *pList, const void *pIn);
+bool SkipListPrependItem(SkipList *pList, const void *pIn);
+bool SkipListDeleteItem(SkipList *pList, int index);
+bool SkipListDeleteHeadItem(SkipList *pList);
+bool SkipListDeleteTailItem(SkipList *pList);
+
+#pragma mark - Ordered Set
+
+// The functions below need the list made by SkipListInitWithCompareFunc,
+// and keep working only if all items are put in by SkipListAddItem
+
+// Insert after the equal items, return the index of the new item, return -1 if failed, return -2 if parameters invalid
+int  SkipListAddItem(SkipList *pList, const void *pIn);
+// Delete the first equal item, return false if no such item
+bool SkipListRemoveItem(SkipList *pList, const void *pVal);
+// Return index of the first equal item, return -1 if no such item, return -2 if parameters invalid
+int  SkipListFind(const SkipList *pList, const void *pVal);
+// Return index of the first item not less than pVal (pList->length if none), return -2 if parameters invalid
+int  SkipListLowerBound(const SkipList *pList, const void *pVal);
+// Return index of the first item greater than pVal (pList->length if none), return -2 if parameters invalid
+int  SkipListUpperBound(const SkipList *pList, const void *pVal);
+// Call pFunc on every item in range [pLow, pHigh), return the count of them, return -2 if parameters invalid
+int  SkipListTraverseRange(SkipList *pList, const void *pLow, const void *pHigh, void (*pFunc)(void *));
+
+#endif
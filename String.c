@@ -7,6 +7,28 @@
 //
 
 #include "String.h"
+#include "StringSearch.h"
+#include <limits.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+#include <locale.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 #pragma mark - Dynamic Array Structure
 
@@ -14,422 +36,1408 @@ struct _dynamic_array {
     void *pData;
     int length;
     int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
 };
 
-#pragma mark - Inner Function
+#pragma mark - Character Set Structure
 
-static char *charAt(const Array *pArr, int index) {
-	return (char *)(pArr->pData) + index * pArr->itemSize;
-}
+// Bitmap of 256 characters
+struct _char_set {
+    uint32_t bits[8];
+};
 
-static int compareCh(const void *chA, const void *chB) {
-    return *(const char *)chA - *(const char *)chB;
-}
+// ' ', '\t', '\n', '\r', '\0', '\x0B'
+static const CharSet blankSet = { { 0x00002E01, 0x00000001, 0, 0, 0, 0, 0, 0 } };
 
-#pragma mark - Make String
+#pragma mark - String Pieces Structure
 
-String *StringInit() {
-    return ArrayInit(sizeof(char));
+// The item pointers, the headers and the characters with a '\0' after each piece follow in the same allocation
+struct _string_pieces {
+    // Array of String over the item pointers, borrowed, so a copy of it copies the pointers
+    Array items;
+};
+
+#pragma mark - Inner Function
+
+static bool setContains(const CharSet *pSet, char ch) {
+    unsigned char c = (unsigned char)ch;
+    return (pSet->bits[c >> 5] >> (c & 31)) & 1;
 }
 
-String *StringInitWithCString(const char *pCStr) {
-    if (!pCStr) {
-        return NULL;
+static void setAdd(CharSet *pSet, char ch) {
+    unsigned char c = (unsigned char)ch;
+    pSet->bits[c >> 5] |= (uint32_t)1 << (c & 31);
+}
+
+// Scan inward from both ends once, then move the rest with one memmove
+static bool trimSet(String *pStr, const CharSet *pSet, bool trimLeft, bool trimRight) {
+    if (!pStr || !pSet) {
+        return false;
     }
     
-    String *pStr = StringInit();
-    if (!pStr) {
-        return NULL;
+    const char *pData = pStr->pData;
+    int start = 0;
+    int end = pStr->length;
+    
+    if (trimLeft) {
+        while (start < end && setContains(pSet, pData[start])) {
+            start++;
+        }
+    }
+    if (trimRight) {
+        while (end > start && setContains(pSet, pData[end - 1])) {
+            end--;
+        }
     }
     
-    if (!StringAppendCString(pStr, pCStr)) {
-        StringDestroy(pStr);
-        return NULL;
+    if (start > 0) {
+        // Shrinking alone writes nothing, moving has to unshare the buffer
+        if (!ArrayReserve(pStr, pStr->length)) {
+            return false;
+        }
+        memmove(pStr->pData, (char *)pStr->pData + start, end - start);
     }
+    pStr->length = end - start;
     
-    return pStr;
+    return true;
 }
 
-String *StringSubString(const String *pStr, int start, int length) {
-    return ArraySubArray(pStr, start, length);
+static char *charAt(const Array *pArr, int index) {
+	return (char *)(pArr->pData) + index * pArr->itemSize;
 }
 
-String *StringCopy(const String *pStr) {
-    return ArrayCopy(pStr);
+static int compareCh(const void *chA, const void *chB) {
+    return *(const char *)chA - *(const char *)chB;
 }
 
-String *StringConcat(const String *pStrA, const String *pStrB) {
-    return ArrayConcat(pStrA, pStrB);
+static unsigned char foldASCII(unsigned char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? ch | 0x20 : ch;
 }
 
-// Accept Array of String, join as much as it can(in case of memory insufficient)
-String *StringJoin(const Array *pStrArr, char separator) {
-    if (!pStrArr) {
-        return NULL;
-    }
+// Compare length bytes with ASCII letters folded to lower case, return -1, 0 or 1
+static int compareFolded(const char *pA, const char *pB, int length) {
+    const unsigned char *pUA = (const unsigned char *)pA;
+    const unsigned char *pUB = (const unsigned char *)pB;
+    int i = 0;
     
-    if (pStrArr->length == 0) {
-        return StringInit();
-    }
+#ifdef STRING_SSE2
+    const __m128i beforeA = _mm_set1_epi8('A' - 1);
+    const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
     
-    String *pTemp = NULL;
-    ArrayGetFirstItem(pStrArr, &pTemp);
-    String *pOut = StringCopy(pTemp);
-    if (!pOut) {
-        return NULL;
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(pUA + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(pUB + i));
+        
+        // Signed compares, so bytes >= 0x80 are never taken as upper case
+        __m128i upperA = _mm_and_si128(_mm_cmpgt_epi8(a, beforeA), _mm_cmplt_epi8(a, afterZ));
+        __m128i upperB = _mm_and_si128(_mm_cmpgt_epi8(b, beforeA), _mm_cmplt_epi8(b, afterZ));
+        a = _mm_or_si128(a, _mm_and_si128(upperA, caseBit));
+        b = _mm_or_si128(b, _mm_and_si128(upperB, caseBit));
+        
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+        if (mask) {
+#ifdef _MSC_VER
+            unsigned long offset;
+            _BitScanForward(&offset, mask);
+#else
+            int offset = __builtin_ctz(mask);
+#endif
+            return foldASCII(pUA[i + offset]) > foldASCII(pUB[i + offset]) ? 1 : -1;
+        }
     }
+#endif
     
-    if (pStrArr->length > 1) {
-        for (int i = 1; i < pStrArr->length; i++) {
-            ArrayGetItem(pStrArr, i, &pTemp);
-            if (!StringAppendCharacter(pOut, separator) || !StringAppendString(pOut, pTemp)) {
-                return pOut;
-            }
+    for (; i < length; i++) {
+        unsigned char chA = foldASCII(pUA[i]);
+        unsigned char chB = foldASCII(pUB[i]);
+        if (chA != chB) {
+            return chA > chB ? 1 : -1;
         }
     }
     
-    return pOut;
+    return 0;
 }
 
-// Accept Array of C string, join as much as it can(in case of memory insufficient)
-String *StringJoinC(const Array *pCStrArr, char separator) {
-    if (!pCStrArr) {
-        return NULL;
-    }
+// Flip the case bit of bytes from first to last, which should be ASCII letters of one case
+static void flipCaseRange(char *pData, int length, char first, char last) {
+    int i = 0;
     
-    if (pCStrArr->length == 0) {
-        return StringInit();
-    }
+#ifdef STRING_SSE2
+    const __m128i beforeFirst = _mm_set1_epi8(first - 1);
+    const __m128i afterLast = _mm_set1_epi8(last + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
     
-    char *pCTemp = NULL;
-    ArrayGetFirstItem(pCStrArr, &pCTemp);
-    String *pOut = StringInitWithCString(pCTemp);
-    if (!pOut) {
-        return NULL;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(pData + i));
+        // Signed compares, so bytes >= 0x80 are never in range
+        __m128i inRange = _mm_and_si128(_mm_cmpgt_epi8(bytes, beforeFirst), _mm_cmplt_epi8(bytes, afterLast));
+        _mm_storeu_si128((__m128i *)(pData + i), _mm_xor_si128(bytes, _mm_and_si128(inRange, caseBit)));
     }
+#endif
     
-    if (pCStrArr->length > 1) {
-        for (int i = 1; i < pCStrArr->length; i++) {
-            ArrayGetItem(pCStrArr, i, &pCTemp);
-            if (!StringAppendCharacter(pOut, separator) || !StringAppendCString(pOut, pCTemp)) {
-                return pOut;
-            }
+    for (; i < length; i++) {
+        if (pData[i] >= first && pData[i] <= last) {
+            pData[i] ^= 0x20;
         }
     }
-    
-    return pOut;
 }
 
-// Accept Array of String, join as much as it can(in case of memory insufficient), you should free the C string by yourself
-char *CStringJoin(const Array *pStrArr, char separator) {
-    if (!pStrArr) {
-        return NULL;
-    }
-    
-    char *pCOut = malloc(1);
-    
-    if (!pCOut) {
-        return NULL;
+// Length of the valid UTF-8 sequence at p, 0 if invalid, overlong forms, surrogates and code points above U+10FFFF are invalid
+static int utf8SequenceLength(const unsigned char *p, const unsigned char *pEnd) {
+    unsigned char lead = p[0];
+    if (lead < 0x80) {
+        return 1;
     }
     
-    if (pStrArr->length == 0) {
-        *pCOut = '\0';
-        return pCOut;
+    // Range of the second byte, the others are always 0x80 to 0xBF
+    int length;
+    unsigned char low = 0x80, high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
     }
     
-    String *pCurr = NULL;
-    ArrayGetFirstItem(pStrArr, &pCurr);
-    if (!realloc(pCOut, pCurr->length + 1)) {
-        return pCOut;
+    if (pEnd - p < length || p[1] < low || p[1] > high) {
+        return 0;
     }
-    memcpy(pCOut, pCurr->pData, pCurr->length);
-    *(pCOut + pCurr->length) = '\0';
-    
-    for (int i = 1; i < pStrArr->length; i++) {
-        ArrayGetItem(pStrArr, i, &pCurr);
-        if (!realloc(pCOut, strlen(pCOut) + 1/*sep*/ + pCurr->length + 1)) {
-            return pCOut;
+    for (int i = 2; i < length; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
         }
-        int length = (int)strlen(pCOut);
-        *(pCOut + length) = separator;
-        memcpy(pCOut + length + 1, pCurr->pData, pCurr->length);
-        *(pCOut + length + 1 + pCurr->length) = '\0';
     }
     
-    return pCOut;
+    return length;
 }
 
-// Return Array of String
-Array *StringSplit(const String *pStr, char separator) {
-    if (!pStr) {
-        return NULL;
-    }
-    
-    Array *pOut = ArrayInit(sizeof(String *));
-    
-    int index = -1;
-    bool couldSplit = false;
-    for (int i = 0; i < pStr->length; i++) {
-        //TODO
+// Bytes of the piece at index in an Array of String or of C string
+static const char *joinPiece(const Array *pArr, int index, bool isCString, int *pLength) {
+    if (isCString) {
+        const char *pCStr = *(const char **)charAt(pArr, index);
+        size_t length = pCStr ? strlen(pCStr) : 0;
+        *pLength = length > INT_MAX ? -1 : (int)length;
+        return pCStr;
     }
     
-    return pOut;
+    const String *pStr = *(const String **)charAt(pArr, index);
+    *pLength = pStr ? pStr->length : 0;
+    return pStr ? pStr->pData : NULL;
 }
 
-// Return Array of String
-Array *StringSplitC(const char *pCStr, char separator); //TODO
-// Return Array of C string
-Array *CStringSplit(const String *pStr, char separator); //TODO
-
-char *StringCString(const String *pStr) {
-    if (!pStr) {
-        return NULL;
+// Length of the joined pieces, return -1 if it doesn't fit in int
+static int joinedLength(const Array *pArr, bool isCString, int sepLength) {
+    if (pArr->length == 0) {
+        return 0;
     }
     
-    char *pCStr = calloc(pStr->length + 1, sizeof(char));
-    if (!pCStr) {
-        return NULL;
+    long long total = (long long)sepLength * (pArr->length - 1);
+    for (int i = 0; i < pArr->length && total <= INT_MAX; i++) {
+        int length;
+        joinPiece(pArr, i, isCString, &length);
+        if (length < 0) {
+            return -1;
+        }
+        total += length;
     }
     
-    memcpy(pCStr, pStr->pData, pStr->length * pStr->itemSize);
-    pCStr[pStr->length] = '\0';
-    
-    return pCStr;
+    return total > INT_MAX ? -1 : (int)total;
 }
 
-char *StringSubCString(const String *pStr, int start, int length) {
-    if (!pStr) {
+// pOut should have room for joinedLength() characters
+static void joinInto(char *pOut, const Array *pArr, bool isCString, const char *pSep, int sepLength) {
+    for (int i = 0; i < pArr->length; i++) {
+        if (i > 0 && sepLength > 0) {
+            memcpy(pOut, pSep, sepLength);
+            pOut += sepLength;
+        }
+        
+        int length;
+        const char *pPiece = joinPiece(pArr, i, isCString, &length);
+        if (length > 0) {
+            memcpy(pOut, pPiece, length);
+            pOut += length;
+        }
+    }
+}
+
+// Compute the exact length first, allocate once and copy every piece
+static String *joinToString(const Array *pArr, bool isCString, const char *pSep, int sepLength) {
+    if (!pArr) {
         return NULL;
     }
     
-    if (start < 0 || length < 0 || start + length > pStr->length) {
+    int length = joinedLength(pArr, isCString, sepLength);
+    if (length < 0) {
         return NULL;
     }
     
-    char *pSubCStr = calloc(length + 1, sizeof(char));
-    if (!pSubCStr) {
+    String *pOut = StringInit();
+    // One more for the '\0' StringCStringView writes
+    if (!pOut || length == INT_MAX || !ArrayReserve(pOut, length + 1)) {
+        StringDestroy(pOut);
         return NULL;
     }
     
-    memcpy(pSubCStr, charAt(pStr, start), length * pStr->itemSize);
-    pSubCStr[length] = '\0';
+    joinInto(pOut->pData, pArr, isCString, pSep, sepLength);
+    pOut->length = length;
     
-    return pSubCStr;
-}
-
-#pragma mark - Get Properties
-
-int StringLength(const String *pStr) {
-    return pStr ? pStr->length : -1;
-}
-
-#pragma mark - Manipulate Whole String
-
-void StringTraverse(String *pStr, void (*pFunc)(void *)) {
-    ArrayTraverse(pStr, pFunc);
-}
-
-#pragma mark ---Modify
-void StringDestroy(String *pStr) {
-    ArrayDestroy(pStr);
-}
-
-void StringClear(String *pStr) {
-    ArrayClear(pStr);
+    return pOut;
 }
 
-// Probably mess up the original order if memory is not enough
-bool StringReverse(String *pStr) {
-    return ArrayReverse(pStr);
+typedef struct _byte_span {
+    const char *pData;
+    int length;
+} ByteSpan;
+
+// Found occurrence, which pair it belongs to is only used by the batch replace
+typedef struct _replace_match {
+    int index;
+    int pair;
+} ReplaceMatch;
+
+static bool appendMatch(ReplaceMatch **ppMatches, int *pCount, int *pCapacity, int index, int pair) {
+    if (*pCount == *pCapacity) {
+        int capacity = *pCapacity ? *pCapacity * 2 : 16;
+        ReplaceMatch *pMatches = realloc(*ppMatches, capacity * sizeof(ReplaceMatch));
+        if (!pMatches) {
+            return false;
+        }
+        *ppMatches = pMatches;
+        *pCapacity = capacity;
+    }
+    
+    (*ppMatches)[*pCount].index = index;
+    (*ppMatches)[*pCount].pair = pair;
+    (*pCount)++;
+    
+    return true;
 }
 
-bool StringTrimCharacter(String *pStr, char ch) {
-    if (!pStr) {
-        return false;
+// Build the replaced content in one new buffer of the exact size, then swap it in
+static bool replaceMatches(String *pStr, const ReplaceMatch *pMatches, int count,
+                           const ByteSpan *pOlds, const ByteSpan *pNews) {
+    if (count == 0) {
+        return true;
     }
     
-    if (ch < 0) {
+    long long newLength = pStr->length;
+    for (int i = 0; i < count; i++) {
+        newLength += pNews[pMatches[i].pair].length - pOlds[pMatches[i].pair].length;
+    }
+    if (newLength >= INT_MAX) {
         return false;
     }
     
-    char item = '\0';
+    String *pOut = StringInit();
+    // One more for the '\0' StringCStringView writes
+    if (!pOut || !ArrayReserve(pOut, (int)newLength + 1)) {
+        StringDestroy(pOut);
+        return false;
+    }
     
-    bool trimmingLeft = true;
-    for (;;) {
-        if (!pStr->length) {
-            return true;
-        }
-        
-        item = trimmingLeft ? StringFirstCharacter(pStr) : StringLastCharacter(pStr);
-        
-        if (item == ch) {
-            if (!(trimmingLeft ? StringDeleteFirstCharacter(pStr) : StringDeleteLastCharacter(pStr))) {
-                return false;
-            }
-        } else {
-            if (trimmingLeft) {
-                trimmingLeft = false;
-            } else {
-                break;
-            }
+    const char *pSrc = pStr->pData;
+    char *pDst = pOut->pData;
+    int last = 0;
+    for (int i = 0; i < count; i++) {
+        const ByteSpan *pNew = &pNews[pMatches[i].pair];
+        memcpy(pDst, pSrc + last, pMatches[i].index - last);
+        pDst += pMatches[i].index - last;
+        if (pNew->length > 0) {
+            memcpy(pDst, pNew->pData, pNew->length);
         }
+        pDst += pNew->length;
+        last = pMatches[i].index + pOlds[pMatches[i].pair].length;
     }
+    memcpy(pDst, pSrc + last, pStr->length - last);
+    pOut->length = (int)newLength;
+    
+    // Swap the buffers, the old one goes with pOut
+    String temp = *pStr;
+    *pStr = *pOut;
+    *pOut = temp;
+    StringDestroy(pOut);
     
     return true;
 }
 
-bool StringTrimCharacters(String *pStr, Array *pChsArr) {
-    if (!pStr || !pChsArr) {
+// Negative maxCount means no limit
+static bool replaceSpan(String *pStr, ByteSpan oldSpan, ByteSpan newSpan, int maxCount) {
+    if (oldSpan.length == 0) {
         return false;
     }
     
-    for (int i = 0; i < pChsArr->length; i++) {
-        if (!StringTrimCharacter(pStr, StringCharacter(pChsArr, i))) {
-            return false;
-        }
-    }
-    
-    return true;
-}
-
-// Trim blank characters
-bool StringTrim(String *pStr) {
-    if (!pStr) {
+    StringSearcher *pSearcher = StringSearcherInitWithBytes(oldSpan.pData, oldSpan.length);
+    if (!pSearcher) {
         return false;
     }
     
-    Array *pChsArr = ArrayInit(sizeof(char));
-    char chs[6] = {' ', '\t', '\n', '\r', '\0', '\x0B'};
-    for (int i = 0; i < 6; i++) {
-        if (!ArrayAppendItem(pChsArr, &chs[i])) {
-            ArrayDestroy(pChsArr);
+    ReplaceMatch *pMatches = NULL;
+    int count = 0, capacity = 0;
+    int index = 0;
+    while ((maxCount < 0 || count < maxCount) &&
+           (index = StringSearcherFindInBytes(pSearcher, pStr->pData, pStr->length, index)) >= 0) {
+        if (!appendMatch(&pMatches, &count, &capacity, index, 0)) {
+            free(pMatches);
+            StringSearcherDestroy(pSearcher);
             return false;
         }
+        index += oldSpan.length;
     }
     
-    bool result = StringTrimCharacters(pStr, pChsArr);
+    bool result = replaceMatches(pStr, pMatches, count, &oldSpan, &newSpan);
+    
+    free(pMatches);
+    StringSearcherDestroy(pSearcher);
     
-    ArrayDestroy(pChsArr);
     return result;
 }
 
-#pragma mark ---Do Not Modify
-
-void StringPrint(const String *pStr) {
-    printf("%s\n", StringCString(pStr));
-}
-
-// Return -1 if no such character, return -2 if parameters invalid
-int  StringFindCharacter(const String *pStr, char ch) {
-    return ArrayFind(pStr, &ch, compareCh);
-}
-
-// Return -1 if no such character, return -2 if parameters invalid
-int  StringFindSubString(const String *pStr, const String *pSub) {
-    if (!pStr || !pSub) {
-        return -2;
+static bool replacePairs(String *pStr, const Array *pOldArr, const Array *pNewArr, bool isCString) {
+    if (!pStr || !pOldArr || !pNewArr || pOldArr->length != pNewArr->length) {
+        return false;
     }
     
-    if (pStr->length < pSub->length) {
-        return -1;
+    int pairCount = pOldArr->length;
+    ByteSpan *pSpans = malloc((2 * pairCount + 1) * sizeof(ByteSpan) + (pairCount + 1) * sizeof(int));
+    if (!pSpans) {
+        return false;
     }
     
-    int index = -1;
-    for (int i = 0; i < pStr->length; i++) {
-        if (pStr->length - i < pSub->length) {
-            break;
-        }
-        
-        if (StringCharacter(pStr, i) == StringFirstCharacter(pSub)) {
-            for (int j = 0; j < pSub->length; j++) {
-                if (StringCharacter(pStr, i + j) != StringCharacter(pSub, j)) {
-                    break;
-                }
-                
-                if (j == pSub->length - 1) {
-                    index = i;
-                }
+    ByteSpan *pOlds = pSpans;
+    ByteSpan *pNews = pSpans + pairCount;
+    // Pairs sharing the first character are chained in order, starting from firstPair
+    int *pNextPair = (int *)(pNews + pairCount + 1);
+    int firstPair[256];
+    for (int c = 0; c < 256; c++) {
+        firstPair[c] = -1;
+    }
+    
+    for (int i = 0; i < pairCount; i++) {
+        if (isCString) {
+            const char *pOld = ((const char **)pOldArr->pData)[i];
+            const char *pNew = ((const char **)pNewArr->pData)[i];
+            if (!pOld || !pNew) {
+                free(pSpans);
+                return false;
+            }
+            pOlds[i].pData = pOld;
+            pOlds[i].length = (int)strlen(pOld);
+            pNews[i].pData = pNew;
+            pNews[i].length = (int)strlen(pNew);
+        } else {
+            const String *pOld = ((const String **)pOldArr->pData)[i];
+            const String *pNew = ((const String **)pNewArr->pData)[i];
+            if (!pOld || !pNew) {
+                free(pSpans);
+                return false;
             }
+            pOlds[i].pData = pOld->pData;
+            pOlds[i].length = pOld->length;
+            pNews[i].pData = pNew->pData;
+            pNews[i].length = pNew->length;
         }
         
-        if (index >= 0) {
-            break; // Found
+        if (pOlds[i].length == 0) {
+            free(pSpans);
+            return false;
         }
     }
     
-    return index;
-}
-
-// Return -1 if no such character, return -2 if parameters invalid
-int  StringFindSubCString(const String *pStr, const char *pCSub) {
-    if (!pStr || !pCSub) {
-        return -2;
-    }
-
-	int cSubLength = (int)strlen(pCSub);
-    
-    if (pStr->length < cSubLength) {
-        return -1;
+    for (int i = pairCount - 1; i >= 0; i--) {
+        unsigned char first = (unsigned char)pOlds[i].pData[0];
+        pNextPair[i] = firstPair[first];
+        firstPair[first] = i;
     }
     
-    int index = -1;
-    for (int i = 0; i < pStr->length; i++) {
-        if (pStr->length - i < cSubLength) {
-            break;
+    ReplaceMatch *pMatches = NULL;
+    int count = 0, capacity = 0;
+    const unsigned char *pText = pStr->pData;
+    for (int i = 0; i < pStr->length; ) {
+        int pair = firstPair[pText[i]];
+        for (; pair >= 0; pair = pNextPair[pair]) {
+            if (pOlds[pair].length <= pStr->length - i &&
+                0 == memcmp(pText + i, pOlds[pair].pData, pOlds[pair].length)) {
+                break;
+            }
         }
         
-        if (StringCharacter(pStr, i) == *pCSub) {
-            for (int j = 0; j < cSubLength; j++) {
-                if (StringCharacter(pStr, i + j) != *(pCSub + j)) {
-                    break;
-                }
-                
-                if (j == cSubLength - 1) {
-                    index = i;
-                }
-            }
+        if (pair < 0) {
+            i++;
+            continue;
         }
         
-        if (index >= 0) {
-            break; // Found
+        if (!appendMatch(&pMatches, &count, &capacity, i, pair)) {
+            free(pMatches);
+            free(pSpans);
+            return false;
         }
+        i += pOlds[pair].length;
     }
     
-    return index;
+    bool result = replaceMatches(pStr, pMatches, count, pOlds, pNews);
+    
+    free(pMatches);
+    free(pSpans);
+    
+    return result;
 }
 
-// Accept only non-NULL parameters (Return 0 if any parameter is invalid)
-int  StringCompare(const String *pStrA, const String *pStrB) {
-    if (!pStrA || !pStrB) {
-        return 0;
+// Make room for extra more characters and the '\0' StringCStringView writes, double the capacity when growing
+// Reserving also unshares the buffer when it doesn't need to grow
+static bool reserveMore(String *pStr, int extra) {
+    if (extra < 0 || extra > INT_MAX - pStr->length) {
+        return false;
     }
     
-    for (int i = 0; i < pStrA->length; i++) {
-        char chA = StringCharacter(pStrA, i);
-        char chB = StringCharacter(pStrB, i);
-        
-        if (chA != chB) {
-            return compareCh(&chA, &chB) > 0 ? 1 : -1;
+    int capacity = pStr->capacity;
+    int minCapacity = pStr->length + extra < INT_MAX ? pStr->length + extra + 1 : INT_MAX;
+    if (minCapacity > capacity) {
+        capacity = capacity > INT_MAX / 2 ? INT_MAX : capacity * 2;
+        if (capacity < minCapacity) {
+            capacity = minCapacity;
         }
     }
     
-    return 0;
+    return ArrayReserve(pStr, capacity);
 }
 
-#pragma mark - Manipulate Single Character
-
-#pragma mark ---Get
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
-bool StringGetCharacter(const String *pStr, int index, char *pOut) {
-    return ArrayGetItem(pStr, index, pOut);
+static int decimalLength(uint64_t value) {
+    int length = 1;
+    for (uint64_t bound = 10; length < 20 && value >= bound; bound *= 10) {
+        length++;
+    }
+    
+    return length;
 }
 
-bool StringGetFirstCharacter(const String *pStr, char *pOut) {
-    return ArrayGetFirstItem(pStr, pOut);
+// Write the digits of value backwards from pEnd, two at a time
+static void writeDigits(char *pEnd, uint64_t value) {
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100);
+        value /= 100;
+        pEnd -= 2;
+        memcpy(pEnd, digitPairs + pair * 2, 2);
+    }
+    
+    if (value >= 10) {
+        memcpy(pEnd - 2, digitPairs + value * 2, 2);
+    } else {
+        pEnd[-1] = (char)('0' + value);
+    }
 }
 
-bool StringGetLastCharacter(const String *pStr, char *pOut) {
-    return ArrayGetLastItem(pStr, pOut);
+// Write the number straight into the spare capacity
+static bool appendInteger(String *pStr, uint64_t magnitude, bool negative) {
+    if (!pStr) {
+        return false;
+    }
+    
+    int count = decimalLength(magnitude) + (negative ? 1 : 0);
+    if (!reserveMore(pStr, count)) {
+        return false;
+    }
+    
+    char *pOut = charAt(pStr, pStr->length);
+    writeDigits(pOut + count, magnitude);
+    if (negative) {
+        pOut[0] = '-';
+    }
+    pStr->length += count;
+    
+    return true;
+}
+
+// Parse decimal digits into a magnitude of at most limit
+static bool parseMagnitude(const char *pData, const char *pEnd, uint64_t limit, uint64_t *pOut) {
+    if (pData == pEnd) {
+        return false;
+    }
+    
+    uint64_t value = 0;
+    for (; pData < pEnd; pData++) {
+        unsigned digit = (unsigned char)*pData - '0';
+        if (digit > 9 || value > (limit - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    
+    *pOut = value;
+    
+    return true;
+}
+
+// Compare the rest of the input with a lower case word, ignoring ASCII case
+static bool matchWord(const char *pData, const char *pEnd, const char *pWord) {
+    for (; *pWord; pWord++, pData++) {
+        if (pData == pEnd || foldASCII((unsigned char)*pData) != (unsigned char)*pWord) {
+            return false;
+        }
+    }
+    
+    return pData == pEnd;
+}
+
+// The decimal point of the C library's locale, printf and strtod use it instead of '.'
+static const char *localeDecimalPoint(void) {
+    const char *pPoint = localeconv()->decimal_point;
+    return pPoint && *pPoint ? pPoint : ".";
+}
+
+// Correctly rounded by strtod, which needs a '\0' after the number and the locale's decimal point for '.'
+// The bytes were checked to be a number already, so a locale's decimal point in them never gets here
+static bool parseDoubleSlow(const char *pBytes, int length, double *pOut) {
+    const char *pPoint = localeDecimalPoint();
+    size_t pointLength = strlen(pPoint);
+    
+    char buffer[64];
+    size_t size = (size_t)length + pointLength + 1;
+    char *pCopy = size <= sizeof(buffer) ? buffer : malloc(size);
+    if (!pCopy) {
+        return false;
+    }
+    
+    char *pDest = pCopy;
+    for (int i = 0; i < length; i++) {
+        if (pBytes[i] == '.') {
+            memcpy(pDest, pPoint, pointLength);
+            pDest += pointLength;
+        } else {
+            *pDest++ = pBytes[i];
+        }
+    }
+    *pDest = '\0';
+    
+    char *pEnd;
+    double value = strtod(pCopy, &pEnd);
+    bool isValid = pEnd == pDest;
+    
+    if (pCopy != buffer) {
+        free(pCopy);
+    }
+    
+    if (isValid) {
+        *pOut = value;
+    }
+    
+    return isValid;
+}
+
+// Format with %.*g and put '.' back for the locale's decimal point, return the length or -1
+static int formatDouble(char *pOut, int size, double value, int precision) {
+    int length = snprintf(pOut, size, "%.*g", precision, value);
+    if (length < 0 || length >= size) {
+        return -1;
+    }
+    
+    const char *pPoint = localeDecimalPoint();
+    if (pPoint[0] == '.' && pPoint[1] == '\0') {
+        return length;
+    }
+    
+    char *pFound = strstr(pOut, pPoint);
+    if (pFound) {
+        size_t pointLength = strlen(pPoint);
+        *pFound = '.';
+        memmove(pFound + 1, pFound + pointLength, pOut + length + 1 - (pFound + pointLength));
+        length -= (int)pointLength - 1;
+    }
+    
+    return length;
+}
+
+#pragma mark - Make String
+
+String *StringInit() {
+    return ArrayInit(sizeof(char));
+}
+
+String *StringInitWithCString(const char *pCStr) {
+    if (!pCStr) {
+        return NULL;
+    }
+    
+    return StringInitWithBytes(pCStr, (int)strlen(pCStr));
+}
+
+String *StringInitWithBytes(const char *pBytes, int length) {
+    if ((!pBytes && length > 0) || length < 0) {
+        return NULL;
+    }
+    
+    String *pStr = StringInit();
+    if (!pStr) {
+        return NULL;
+    }
+    
+    if (!StringAppendBytes(pStr, pBytes, length)) {
+        StringDestroy(pStr);
+        return NULL;
+    }
+    
+    return pStr;
+}
+
+String *StringSubString(const String *pStr, int start, int length) {
+    return ArraySubArray(pStr, start, length);
+}
+
+String *StringCopy(const String *pStr) {
+    return ArrayCopy(pStr);
+}
+
+String *StringConcat(const String *pStrA, const String *pStrB) {
+    return ArrayConcat(pStrA, pStrB);
+}
+
+// Accept Array of String, return NULL if memory is not enough
+String *StringJoin(const Array *pStrArr, char separator) {
+    return joinToString(pStrArr, false, &separator, 1);
+}
+
+// Accept Array of C string, return NULL if memory is not enough
+String *StringJoinC(const Array *pCStrArr, char separator) {
+    return joinToString(pCStrArr, true, &separator, 1);
+}
+
+// Accept Array of String, return NULL if memory is not enough
+String *StringJoinWith(const Array *pStrArr, const String *pSeparator) {
+    if (!pSeparator) {
+        return NULL;
+    }
+    
+    return joinToString(pStrArr, false, pSeparator->pData, pSeparator->length);
+}
+
+// Accept Array of String, return NULL if memory is not enough, you should free the C string by yourself
+char *CStringJoin(const Array *pStrArr, char separator) {
+    if (!pStrArr) {
+        return NULL;
+    }
+    
+    int length = joinedLength(pStrArr, false, 1);
+    if (length < 0) {
+        return NULL;
+    }
+    
+    char *pCOut = malloc((size_t)length + 1);
+    if (!pCOut) {
+        return NULL;
+    }
+    
+    joinInto(pCOut, pStrArr, false, &separator, 1);
+    pCOut[length] = '\0';
+    
+    return pCOut;
+}
+
+static const char *nextSeparator(const char *p, const char *pEnd, char separator, const CharSet *pSet) {
+    if (!pSet) {
+        return p < pEnd ? memchr(p, separator, pEnd - p) : NULL;
+    }
+    
+    for (; p < pEnd; p++) {
+        if (setContains(pSet, *p)) {
+            return p;
+        }
+    }
+    
+    return NULL;
+}
+
+static int countPieces(const char *pData, int length, char separator, const CharSet *pSet) {
+    const char *pEnd = pData + length;
+    
+    int count = 1;
+    for (const char *p = pData; (p = nextSeparator(p, pEnd, separator, pSet)); p++) {
+        count++;
+    }
+    
+    return count;
+}
+
+// Copy the bytes into pBytes with a '\0' for each separator and one at the end,
+// then point a header at each piece if pHeaders is not NULL, or a C string otherwise
+static void cutPieces(const char *pData, int length, char separator, const CharSet *pSet,
+                      char *pBytes, String *pHeaders, char **ppCStrs) {
+    if (length > 0) {
+        memcpy(pBytes, pData, length);
+    }
+    char *pEnd = pBytes + length;
+    *pEnd = '\0';
+    
+    char *pStart = pBytes;
+    for (int i = 0; ; i++) {
+        char *pSep = (char *)nextSeparator(pStart, pEnd, separator, pSet);
+        char *pStop = pSep ? pSep : pEnd;
+        *pStop = '\0';
+        
+        if (pHeaders) {
+            pHeaders[i].pData = pStart;
+            pHeaders[i].length = (int)(pStop - pStart);
+            pHeaders[i].itemSize = sizeof(char);
+            // The '\0' after the piece counts as capacity, see StringCStringView
+            pHeaders[i].capacity = pHeaders[i].length + 1;
+            // Borrowed from the pieces, copies of a piece copy the characters
+            pHeaders[i].pBuffer = NULL;
+        } else {
+            ppCStrs[i] = pStart;
+        }
+        
+        if (!pSep) {
+            break;
+        }
+        pStart = pSep + 1;
+    }
+}
+
+// Split at separator, or at any character in pSet if it is not NULL, in one allocation
+static StringPieces *splitPieces(const char *pData, int length, char separator, const CharSet *pSet) {
+    int count = countPieces(pData, length, separator, pSet);
+    
+    size_t itemSize = sizeof(String *) + sizeof(String);
+    if ((size_t)count > (SIZE_MAX - sizeof(StringPieces) - length - 1) / itemSize) {
+        return NULL;
+    }
+    StringPieces *pPieces = malloc(sizeof(StringPieces) + count * itemSize + length + 1);
+    if (!pPieces) {
+        return NULL;
+    }
+    
+    String **ppItems = (String **)(pPieces + 1);
+    String *pHeaders = (String *)(ppItems + count);
+    cutPieces(pData, length, separator, pSet, (char *)(pHeaders + count), pHeaders, NULL);
+    for (int i = 0; i < count; i++) {
+        ppItems[i] = &pHeaders[i];
+    }
+    
+    pPieces->items.pData = ppItems;
+    pPieces->items.length = count;
+    pPieces->items.itemSize = sizeof(String *);
+    pPieces->items.capacity = count;
+    pPieces->items.pBuffer = NULL;
+    
+    return pPieces;
+}
+
+// Return the pieces, return NULL if memory is not enough, you should destroy them by yourself
+StringPieces *StringSplit(const String *pStr, char separator) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    return splitPieces(pStr->pData, pStr->length, separator, NULL);
+}
+
+// Return the pieces, return NULL if memory is not enough, you should destroy them by yourself
+StringPieces *StringSplitC(const char *pCStr, char separator) {
+    if (!pCStr) {
+        return NULL;
+    }
+    
+    return splitPieces(pCStr, (int)strlen(pCStr), separator, NULL);
+}
+
+// Return C strings ending with NULL in one allocation, return NULL if memory is not enough, you should free it by yourself
+char **CStringSplit(const String *pStr, char separator) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    int length = pStr->length;
+    int count = countPieces(pStr->pData, length, separator, NULL);
+    
+    if ((size_t)count >= (SIZE_MAX - length - 1) / sizeof(char *)) {
+        return NULL;
+    }
+    char **ppCStrs = malloc((count + 1) * sizeof(char *) + length + 1);
+    if (!ppCStrs) {
+        return NULL;
+    }
+    
+    cutPieces(pStr->pData, length, separator, NULL, (char *)(ppCStrs + count + 1), NULL, ppCStrs);
+    ppCStrs[count] = NULL;
+    
+    return ppCStrs;
+}
+
+// Split at any character in pSet, return the pieces, return NULL if memory is not enough, you should destroy them by yourself
+StringPieces *StringSplitCharSet(const String *pStr, const CharSet *pSet) {
+    if (!pStr || !pSet) {
+        return NULL;
+    }
+    
+    return splitPieces(pStr->pData, pStr->length, '\0', pSet);
+}
+
+char *StringCString(const String *pStr) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    char *pCStr = calloc(pStr->length + 1, sizeof(char));
+    if (!pCStr) {
+        return NULL;
+    }
+    
+    memcpy(pCStr, pStr->pData, pStr->length * pStr->itemSize);
+    pCStr[pStr->length] = '\0';
+    
+    return pCStr;
+}
+
+// Write a '\0' after the last character and return the buffer, valid until the string changes
+// Copy the buffer first if it is shared, return NULL if memory is not enough
+const char *StringCStringView(String *pStr) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    if (!pStr->pData) {
+        return "";
+    }
+    
+    // Borrowed storage may already end with '\0', as split pieces and pool strings do, unless it was shortened since
+    // Other borrowed storage is copied by ArrayReserve below
+    if (!pStr->pBuffer && pStr->capacity > pStr->length && ((const char *)pStr->pData)[pStr->length] == '\0') {
+        return pStr->pData;
+    }
+    
+    // O(1) when the buffer is not shared and has spare capacity, which growing always leaves
+    if (pStr->length == INT_MAX || !ArrayReserve(pStr, pStr->length + 1)) {
+        return NULL;
+    }
+    ((char *)pStr->pData)[pStr->length] = '\0';
+    
+    return pStr->pData;
+}
+
+char *StringSubCString(const String *pStr, int start, int length) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    if (start < 0 || length < 0 || start + length > pStr->length) {
+        return NULL;
+    }
+    
+    char *pSubCStr = calloc(length + 1, sizeof(char));
+    if (!pSubCStr) {
+        return NULL;
+    }
+    
+    memcpy(pSubCStr, charAt(pStr, start), length * pStr->itemSize);
+    pSubCStr[length] = '\0';
+    
+    return pSubCStr;
+}
+
+#pragma mark - Get Properties
+
+int StringLength(const String *pStr) {
+    return pStr ? pStr->length : -1;
+}
+
+#pragma mark - Manipulate Whole String
+
+void StringTraverse(String *pStr, void (*pFunc)(void *)) {
+    ArrayTraverse(pStr, pFunc);
+}
+
+#pragma mark ---Modify
+void StringDestroy(String *pStr) {
+    ArrayDestroy(pStr);
+}
+
+void StringClear(String *pStr) {
+    ArrayClear(pStr);
+}
+
+// Probably mess up the original order if memory is not enough
+bool StringReverse(String *pStr) {
+    return ArrayReverse(pStr);
+}
+
+bool StringTrimCharacter(String *pStr, char ch) {
+    CharSet set = { { 0 } };
+    setAdd(&set, ch);
+    
+    return trimSet(pStr, &set, true, true);
+}
+
+// Accept Array of char
+bool StringTrimCharacters(String *pStr, Array *pChsArr) {
+    if (!pStr || !pChsArr) {
+        return false;
+    }
+    
+    CharSet set = { { 0 } };
+    for (int i = 0; i < pChsArr->length; i++) {
+        setAdd(&set, *charAt(pChsArr, i));
+    }
+    
+    return trimSet(pStr, &set, true, true);
+}
+
+bool StringTrimCharSet(String *pStr, const CharSet *pSet) {
+    return trimSet(pStr, pSet, true, true);
+}
+
+bool StringTrimLeftCharSet(String *pStr, const CharSet *pSet) {
+    return trimSet(pStr, pSet, true, false);
+}
+
+bool StringTrimRightCharSet(String *pStr, const CharSet *pSet) {
+    return trimSet(pStr, pSet, false, true);
+}
+
+// Trim blank characters
+bool StringTrim(String *pStr) {
+    return trimSet(pStr, &blankSet, true, true);
+}
+
+// Trim blank characters
+bool StringTrimLeft(String *pStr) {
+    return trimSet(pStr, &blankSet, true, false);
+}
+
+// Trim blank characters
+bool StringTrimRight(String *pStr) {
+    return trimSet(pStr, &blankSet, false, true);
+}
+
+// ASCII letters only, other bytes are unchanged
+bool StringToLowerASCII(String *pStr) {
+    if (!pStr) {
+        return false;
+    }
+    
+    if (pStr->length == 0) {
+        return true;
+    }
+    // Copy a shared buffer before writing
+    if (!ArrayReserve(pStr, pStr->length)) {
+        return false;
+    }
+    flipCaseRange(pStr->pData, pStr->length, 'A', 'Z');
+    
+    return true;
+}
+
+// ASCII letters only, other bytes are unchanged
+bool StringToUpperASCII(String *pStr) {
+    if (!pStr) {
+        return false;
+    }
+    
+    if (pStr->length == 0) {
+        return true;
+    }
+    // Copy a shared buffer before writing
+    if (!ArrayReserve(pStr, pStr->length)) {
+        return false;
+    }
+    flipCaseRange(pStr->pData, pStr->length, 'a', 'z');
+    
+    return true;
+}
+
+// pTable has 256 entries, each character ch becomes pTable[(unsigned char)ch]
+bool StringTranslate(String *pStr, const char *pTable) {
+    if (!pStr || !pTable) {
+        return false;
+    }
+    
+    if (pStr->length == 0) {
+        return true;
+    }
+    // Copy a shared buffer before writing
+    if (!ArrayReserve(pStr, pStr->length)) {
+        return false;
+    }
+    
+    unsigned char *pData = pStr->pData;
+    int length = pStr->length;
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        unsigned char a = pTable[pData[i]], b = pTable[pData[i + 1]], c = pTable[pData[i + 2]], d = pTable[pData[i + 3]];
+        pData[i] = a;
+        pData[i + 1] = b;
+        pData[i + 2] = c;
+        pData[i + 3] = d;
+    }
+    for (; i < length; i++) {
+        pData[i] = pTable[pData[i]];
+    }
+    
+    return true;
+}
+
+#pragma mark ---Do Not Modify
+
+void StringPrint(const String *pStr) {
+    if (StringWrite(pStr, stdout)) {
+        putchar('\n');
+    }
+}
+
+// Write the characters only, no '\0' or new line
+bool StringWrite(const String *pStr, FILE *pFile) {
+    if (!pStr || !pFile) {
+        return false;
+    }
+    
+    if (pStr->length == 0) {
+        return true;
+    }
+    
+    return fwrite(pStr->pData, 1, pStr->length, pFile) == (size_t)pStr->length;
+}
+
+// Write the characters only, no '\0' or new line, retry until all are written
+bool StringWriteFd(const String *pStr, int fd) {
+    if (!pStr || fd < 0) {
+        return false;
+    }
+    
+    const char *pCurr = pStr->pData;
+    int remaining = pStr->length;
+    while (remaining > 0) {
+#ifdef _WIN32
+        int written = _write(fd, pCurr, (unsigned int)remaining);
+        if (written < 0) {
+            return false;
+        }
+#else
+        ssize_t written = write(fd, pCurr, (size_t)remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+#endif
+        pCurr += written;
+        remaining -= (int)written;
+    }
+    
+    return true;
+}
+
+// Return -1 if no such character, return -2 if parameters invalid
+int  StringFindCharacter(const String *pStr, char ch) {
+    return ArrayFind(pStr, &ch, compareCh);
+}
+
+// Find any character in pSet, return -1 if no such character, return -2 if parameters invalid
+int  StringFindCharSet(const String *pStr, const CharSet *pSet) {
+    if (!pStr || !pSet) {
+        return -2;
+    }
+    
+    for (int i = 0; i < pStr->length; i++) {
+        if (setContains(pSet, *charAt(pStr, i))) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+// Find any character in pSet, return -1 if no such character, return -2 if parameters invalid
+int  StringFindLastCharSet(const String *pStr, const CharSet *pSet) {
+    if (!pStr || !pSet) {
+        return -2;
+    }
+    
+    for (int i = pStr->length - 1; i >= 0; i--) {
+        if (setContains(pSet, *charAt(pStr, i))) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+// Return -1 if no such substring, return -2 if parameters invalid
+int  StringFindSubString(const String *pStr, const String *pSub) {
+    if (!pStr || !pSub) {
+        return -2;
+    }
+    
+    return StringSearchBytes(pStr->pData, pStr->length, pSub->pData, pSub->length, 0);
+}
+
+// Return -1 if no such substring, return -2 if parameters invalid
+int  StringFindSubCString(const String *pStr, const char *pCSub) {
+    if (!pStr || !pCSub) {
+        return -2;
+    }
+    
+    return StringSearchBytes(pStr->pData, pStr->length, pCSub, (int)strlen(pCSub), 0);
+}
+
+// Return -1 if no such substring, return -2 if parameters invalid
+int  StringFindLast(const String *pStr, const String *pSub) {
+    if (!pStr || !pSub) {
+        return -2;
+    }
+    
+    return StringSearchLastBytes(pStr->pData, pStr->length, pSub->pData, pSub->length);
+}
+
+// Return Array of int, the indexes of non-overlapping occurrences, the length of pSub should be greater than 0
+Array *StringFindAll(const String *pStr, const String *pSub) {
+    if (!pStr || !pSub || pSub->length == 0) {
+        return NULL;
+    }
+    
+    StringSearcher *pSearcher = StringSearcherInit(pSub);
+    if (!pSearcher) {
+        return NULL;
+    }
+    
+    Array *pOut = ArrayInit(sizeof(int));
+    if (!pOut) {
+        StringSearcherDestroy(pSearcher);
+        return NULL;
+    }
+    
+    int index = 0;
+    while ((index = StringSearcherFind(pSearcher, pStr, index)) >= 0) {
+        if (!ArrayAppendItem(pOut, &index)) {
+            ArrayDestroy(pOut);
+            pOut = NULL;
+            break;
+        }
+        index += pSub->length;
+    }
+    
+    StringSearcherDestroy(pSearcher);
+    
+    return pOut;
+}
+
+// Count non-overlapping occurrences, the length of pSub should be greater than 0, return -2 if parameters invalid
+int  StringCount(const String *pStr, const String *pSub) {
+    if (!pStr || !pSub || pSub->length == 0) {
+        return -2;
+    }
+    
+    StringSearcher *pSearcher = StringSearcherInit(pSub);
+    if (!pSearcher) {
+        return -2;
+    }
+    
+    int count = 0;
+    int index = 0;
+    while ((index = StringSearcherFind(pSearcher, pStr, index)) >= 0) {
+        count++;
+        index += pSub->length;
+    }
+    
+    StringSearcherDestroy(pSearcher);
+    
+    return count;
+}
+
+// Bytes are compared as unsigned char, a proper prefix orders first
+// Accept only non-NULL parameters (Return 0 if any parameter is invalid)
+int  StringCompare(const String *pStrA, const String *pStrB) {
+    if (!pStrA || !pStrB) {
+        return 0;
+    }
+    
+    int minLength = pStrA->length < pStrB->length ? pStrA->length : pStrB->length;
+    int result = minLength > 0 ? memcmp(pStrA->pData, pStrB->pData, minLength) : 0;
+    if (result) {
+        return result > 0 ? 1 : -1;
+    }
+    
+    return pStrA->length == pStrB->length ? 0 : (pStrA->length > pStrB->length ? 1 : -1);
+}
+
+// Fold ASCII letters only
+// Accept only non-NULL parameters (Return 0 if any parameter is invalid)
+int  StringCompareCaseInsensitive(const String *pStrA, const String *pStrB) {
+    if (!pStrA || !pStrB) {
+        return 0;
+    }
+    
+    int minLength = pStrA->length < pStrB->length ? pStrA->length : pStrB->length;
+    int result = compareFolded(pStrA->pData, pStrB->pData, minLength);
+    if (result) {
+        return result;
+    }
+    
+    return pStrA->length == pStrB->length ? 0 : (pStrA->length > pStrB->length ? 1 : -1);
+}
+
+bool StringEquals(const String *pStrA, const String *pStrB) {
+    if (!pStrA || !pStrB) {
+        return false;
+    }
+    
+    if (pStrA->length != pStrB->length) {
+        return false;
+    }
+    
+    return pStrA->length == 0 || !memcmp(pStrA->pData, pStrB->pData, pStrA->length);
+}
+
+// Fold ASCII letters only
+bool StringEqualsCaseInsensitive(const String *pStrA, const String *pStrB) {
+    if (!pStrA || !pStrB) {
+        return false;
+    }
+    
+    if (pStrA->length != pStrB->length) {
+        return false;
+    }
+    
+    return compareFolded(pStrA->pData, pStrB->pData, pStrA->length) == 0;
+}
+
+// Fast 64-bit non-cryptographic hash, equal strings have equal hashes
+uint64_t StringHash(const String *pStr) {
+    if (!pStr) {
+        return 0;
+    }
+    
+    return StringHashBytes(pStr->pData, pStr->length);
+}
+
+uint64_t StringHashBytes(const void *pData, int length) {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    
+    if (!pData || length < 0) {
+        length = 0;
+    }
+    
+    const unsigned char *p = pData;
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ ((uint64_t)length * m);
+    
+    // Body, 8 bytes at a time
+    for (int nWords = length / 8; nWords > 0; nWords--, p += 8) {
+        uint64_t k;
+        memcpy(&k, p, 8);
+        
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        
+        h ^= k;
+        h *= m;
+    }
+    
+    // Tail
+    uint64_t tail = 0;
+    for (int i = length & 7; i > 0; i--) {
+        tail = (tail << 8) | p[i - 1];
+    }
+    if (length & 7) {
+        h ^= tail;
+        h *= m;
+    }
+    
+    // Finalize
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    
+    return h;
+}
+
+// Reject overlong forms, surrogates and code points above U+10FFFF, ASCII is checked 16 bytes at a time
+bool StringValidateUTF8(const String *pStr) {
+    if (!pStr) {
+        return false;
+    }
+    
+    const unsigned char *p = pStr->pData;
+    const unsigned char *pEnd = p + pStr->length;
+    while (p < pEnd) {
+#ifdef STRING_SSE2
+        if (pEnd - p >= 16 && _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p)) == 0) {
+            p += 16;
+            continue;
+        }
+#endif
+        int length = utf8SequenceLength(p, pEnd);
+        if (length == 0) {
+            return false;
+        }
+        p += length;
+    }
+    
+    return true;
+}
+
+// Count of code points in valid UTF-8, in fact the count of bytes that are not 0x80 to 0xBF, return -2 if parameters invalid
+int StringUTF8Length(const String *pStr) {
+    if (!pStr) {
+        return -2;
+    }
+    
+    const signed char *pData = pStr->pData;
+    int length = pStr->length;
+    int count = 0;
+    int i = 0;
+    
+#ifdef STRING_SSE2
+    // Continuation bytes are -128 to -65 as signed char
+    const __m128i lastContinuation = _mm_set1_epi8(-65);
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 16 <= length) {
+        // Byte counters can take 255 blocks before they overflow
+        __m128i counters = zero;
+        for (int blocks = 0; blocks < 255 && i + 16 <= length; blocks++, i += 16) {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(pData + i));
+            counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(bytes, lastContinuation));
+        }
+        __m128i sums = _mm_sad_epu8(counters, zero);
+        count += _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+    }
+#endif
+    
+    for (; i < length; i++) {
+        count += pData[i] > -65;
+    }
+    
+    return count;
+}
+
+#pragma mark - Manipulate Single Character
+
+#pragma mark ---Get
+
+bool StringGetCharacter(const String *pStr, int index, char *pOut) {
+    return ArrayGetItem(pStr, index, pOut);
+}
+
+bool StringGetFirstCharacter(const String *pStr, char *pOut) {
+    return ArrayGetFirstItem(pStr, pOut);
+}
+
+bool StringGetLastCharacter(const String *pStr, char *pOut) {
+    return ArrayGetLastItem(pStr, pOut);
 }
 
 char StringCharacter(const String *pStr, int index) {
@@ -516,145 +1524,92 @@ bool StringReplaceSubCString(String *pStr, int index, const char *pNewCSub) {
     return true;
 }
 
+// Copy a shared buffer only if oldCh is found
+bool StringReplaceAllCharacter(String *pStr, char oldCh, char newCh) {
+    if (!pStr) {
+        return false;
+    }
+    
+    char *pFound = pStr->length > 0 ? memchr(pStr->pData, oldCh, pStr->length) : NULL;
+    if (!pFound || oldCh == newCh) {
+        return true;
+    }
+    
+    int i = (int)(pFound - (char *)pStr->pData);
+    if (!ArrayReserve(pStr, pStr->length)) {
+        return false;
+    }
+    char *pData = pStr->pData;
+    int length = pStr->length;
+    
+#ifdef STRING_SSE2
+    const __m128i oldBytes = _mm_set1_epi8(oldCh);
+    const __m128i newBytes = _mm_set1_epi8(newCh);
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(pData + i));
+        __m128i isOld = _mm_cmpeq_epi8(bytes, oldBytes);
+        bytes = _mm_or_si128(_mm_andnot_si128(isOld, bytes), _mm_and_si128(isOld, newBytes));
+        _mm_storeu_si128((__m128i *)(pData + i), bytes);
+    }
+#endif
+    
+    for (; i < length; i++) {
+        if (pData[i] == oldCh) {
+            pData[i] = newCh;
+        }
+    }
+    
+    return true;
+}
+
+// Misspelled name kept for existing callers, the same as StringReplaceAllCharacter
 bool StringReplaceAllCharater(String *pStr, char oldCh, char newCh) {
-	if (!pStr) {
-		return false;
-	}
-
-	for (int i = 0; i < pStr->length; i++) {
-		if (StringCharacter(pStr, i) == oldCh) {
-			StringReplaceCharacter(pStr, i, newCh);
-		}
-	}
-
-	return true;
+    return StringReplaceAllCharacter(pStr, oldCh, newCh);
 }
 
 // The length of pOldSub should be greater than 0
 bool StringReplaceAllSubString(String *pStr, const String *pOldSub, const String *pNewSub) {
-	if (!pStr || !pOldSub || !pNewSub) {
-		return false;
-	}
-
-	if (pOldSub->length == 0) {
-		return false;
-	}
-
-	int index = -1;
-	for (int i = 0; i < pStr->length; i++) {
-		if (pStr->length - i < pOldSub->length) {
-			break;
-		}
-
-		if (StringCharacter(pStr, i) == StringFirstCharacter(pOldSub)) {
-			for (int j = 0; j < pOldSub->length; j++) {
-				if (StringCharacter(pStr, i + j) != StringCharacter(pOldSub, j)) {
-					break;
-				}
-
-				if (j == pOldSub->length - 1) {
-					index = i;
-				}
-			}
-		}
-
-		if (index >= 0) {
-			// Found, then replace substring from index to the end of pOldStr
-            int minLength = pOldSub->length < pNewSub->length ? pOldSub->length : pNewSub->length;
-			int j;
-			for (j = 0; j < minLength; j++) {
-				StringReplaceCharacter(pStr, index + j, StringCharacter(pNewSub, j));
-			}
-
-			if (pOldSub->length > pNewSub->length) {
-				for (; j < pOldSub->length; j++) {
-					StringDeleteCharacter(pStr, index + minLength);
-				}
-			} else {
-				for (; j < pNewSub->length; j++) {
-					if (!StringInsertCharacter(pStr, index + j, StringCharacter(pNewSub, j))) {
-						// Delete the characters inserted before
-						for (int k = index + minLength; k < index + j; k++) {
-							StringDeleteCharacter(pStr, k);
-						}
-						return false;
-					}
-				}
-			}
-
-			// Replaced a substring, continue to search
-			i = index + pNewSub->length;
-			index = -1;
-			continue;
-		}
-	}
-
-	return true;
+    return StringReplaceNSubString(pStr, pOldSub, pNewSub, -1);
 }
 
 // The length of pOldCSub should be greater than 0
 bool StringReplaceAllSubCString(String *pStr, const char *pOldCSub, const char *pNewCSub) {
-	if (!pStr || !pOldCSub || !pNewCSub) {
-		return false;
-	}
+    return StringReplaceNSubCString(pStr, pOldCSub, pNewCSub, -1);
+}
 
-	int oldCSubLength = (int)strlen(pOldCSub);
-	int newCSubLength = (int)strlen(pNewCSub);
+// Replace at most maxCount occurrences from the beginning, the length of pOldSub should be greater than 0
+bool StringReplaceNSubString(String *pStr, const String *pOldSub, const String *pNewSub, int maxCount) {
+    if (!pStr || !pOldSub || !pNewSub) {
+        return false;
+    }
+    
+    ByteSpan oldSpan = { pOldSub->pData, pOldSub->length };
+    ByteSpan newSpan = { pNewSub->pData, pNewSub->length };
+    
+    return replaceSpan(pStr, oldSpan, newSpan, maxCount);
+}
 
-	if (oldCSubLength == 0) {
-		return false;
-	}
+// Replace at most maxCount occurrences from the beginning, the length of pOldCSub should be greater than 0
+bool StringReplaceNSubCString(String *pStr, const char *pOldCSub, const char *pNewCSub, int maxCount) {
+    if (!pStr || !pOldCSub || !pNewCSub) {
+        return false;
+    }
+    
+    ByteSpan oldSpan = { pOldCSub, (int)strlen(pOldCSub) };
+    ByteSpan newSpan = { pNewCSub, (int)strlen(pNewCSub) };
+    
+    return replaceSpan(pStr, oldSpan, newSpan, maxCount);
+}
 
-	int index = -1;
-	for (int i = 0; i < pStr->length; i++) {
-		if (pStr->length - i < oldCSubLength) {
-			break;
-		}
-
-		if (StringCharacter(pStr, i) == *pOldCSub) {
-			for (int j = 0; j < oldCSubLength; j++) {
-				if (StringCharacter(pStr, i + j) != *(pOldCSub + j)) {
-					break;
-				}
-
-				if (j == oldCSubLength - 1) {
-					index = i;
-				}
-			}
-		}
-
-		if (index >= 0) {
-			// Found, then replace substring from index to the end of pOldStr
-            int minLength = oldCSubLength < newCSubLength ? oldCSubLength : newCSubLength;
-			int j;
-			for (j = 0; j < minLength; j++) {
-				StringReplaceCharacter(pStr, index + j, *(pNewCSub + j));
-			}
-
-			if (oldCSubLength > newCSubLength) {
-				for (; j < oldCSubLength; j++) {
-					StringDeleteCharacter(pStr, index + minLength);
-				}
-			}
-			else {
-				for (; j < newCSubLength; j++) {
-					if (!StringInsertCharacter(pStr, index + j, *(pNewCSub + j))) {
-						// Delete the characters inserted before
-						for (int k = index + minLength; k < index + j; k++) {
-							StringDeleteCharacter(pStr, k);
-						}
-						return false;
-					}
-				}
-			}
-
-			i = index + newCSubLength;
-			index = -1;
-			continue;
-		}
-	}
+// Accept two Array of String of the same length, replace every pOldSubArr[i] with pNewSubArr[i] in one pass,
+// the leftmost occurrence wins, and the earlier pair wins at the same index. The old ones should not be empty
+bool StringReplaceAllSubStrings(String *pStr, const Array *pOldSubArr, const Array *pNewSubArr) {
+    return replacePairs(pStr, pOldSubArr, pNewSubArr, false);
+}
 
-	return true;
+// Same as StringReplaceAllSubStrings, but accept two Array of C string
+bool StringReplaceAllSubCStrings(String *pStr, const Array *pOldCSubArr, const Array *pNewCSubArr) {
+    return replacePairs(pStr, pOldCSubArr, pNewCSubArr, true);
 }
 
 #pragma mark ---Insert
@@ -664,26 +1619,65 @@ bool StringInsertCharacter(String *pStr, int index, char ch) {
 	return ArrayInsertItem(pStr, index, &ch);
 }
 
+// Accept index range from 0 to pStr->length
 bool StringInsertString(String *pStr, int index, const String *pNewStr) {
-	return ArrayInsertArray(pStr, index, pNewStr);
+	if (!pStr || !pNewStr) {
+		return false;
+	}
+
+	return StringInsertBytes(pStr, index, pNewStr->pData, pNewStr->length);
 }
 
+// Accept index range from 0 to pStr->length
 bool StringInsertCString(String *pStr, int index, const char *pNewCStr) {
 	if (!pStr || !pNewCStr) {
 		return false;
 	}
 
-	for (int i = 0; *(pNewCStr + i) != '\0'; i++) {
-		if (!StringInsertCharacter(pStr, index + i, *(pNewCStr + i))) {
-			// Delete the characters appended before
-			for (int j = 0; j < i; j++) {
-				StringDeleteCharacter(pStr, index);
-			}
-			return false;
-		}
-	}
+	return StringInsertBytes(pStr, index, pNewCStr, (int)strlen(pNewCStr));
+}
 
-	return true;
+// Accept index range from 0 to pStr->length, one capacity check, one memmove and one memcpy
+bool StringInsertBytes(String *pStr, int index, const char *pBytes, int length) {
+    if (!pStr || (!pBytes && length > 0) || length < 0) {
+        return false;
+    }
+    
+    if (index < 0 || index > pStr->length) {
+        return false;
+    }
+    
+    if (length == 0) {
+        return true;
+    }
+    
+    if (length > INT_MAX - pStr->length) {
+        return false;
+    }
+    
+    // The bytes may come from the string itself, which is about to move
+    char *pTemp = NULL;
+    if (pStr->pData && pBytes >= (const char *)pStr->pData && pBytes < (const char *)pStr->pData + pStr->capacity) {
+        pTemp = malloc(length);
+        if (!pTemp) {
+            return false;
+        }
+        memcpy(pTemp, pBytes, length);
+        pBytes = pTemp;
+    }
+    
+    if (!reserveMore(pStr, length)) {
+        free(pTemp);
+        return false;
+    }
+    
+    memmove(charAt(pStr, index + length), charAt(pStr, index), pStr->length - index);
+    memcpy(charAt(pStr, index), pBytes, length);
+    pStr->length += length;
+    
+    free(pTemp);
+    
+    return true;
 }
 
 #pragma mark ---Append & Prepend
@@ -693,25 +1687,103 @@ bool StringAppendCharacter(String *pStr, char ch) {
 }
 
 bool StringAppendString(String *pStr, const String *pNewStr) {
-    return ArrayAppendArray(pStr, pNewStr);
+    if (!pStr) {
+        return false;
+    }
+    
+    return StringInsertString(pStr, pStr->length, pNewStr);
 }
 
 bool StringAppendCString(String *pStr, const char *pNewCStr) {
+	if (!pStr) {
+		return false;
+	}
+
 	return StringInsertCString(pStr, pStr->length, pNewCStr);
 }
 
+bool StringAppendBytes(String *pStr, const char *pBytes, int length) {
+    if (!pStr) {
+        return false;
+    }
+    
+    return StringInsertBytes(pStr, pStr->length, pBytes, length);
+}
+
+bool StringAppendInt64(String *pStr, int64_t value) {
+    // Work on the magnitude as unsigned so INT64_MIN is fine
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    return appendInteger(pStr, magnitude, value < 0);
+}
+
+bool StringAppendUInt64(String *pStr, uint64_t value) {
+    return appendInteger(pStr, value, false);
+}
+
+// Integers below 1e15 in full, others in the fewest %g digits that read back as the same value, with '.' in any locale
+bool StringAppendDouble(String *pStr, double value) {
+    if (!pStr) {
+        return false;
+    }
+    
+    // Integers below 1e15 look the same with %.15g
+    if (value > -1e15 && value < 1e15 && value == (double)(int64_t)value && !(value == 0 && signbit(value))) {
+        return StringAppendInt64(pStr, (int64_t)value);
+    }
+    
+    // Enough for "-1.2345678901234567e-308" and a decimal point of a few bytes
+    char buffer[48];
+    char best[48];
+    int bestLength = -1;
+    
+    if (isfinite(value)) {
+        // 17 digits always read back and more digits are never further off, so search for the fewest
+        int low = 1;
+        int high = 17;
+        while (low < high) {
+            int precision = (low + high) / 2;
+            int length = formatDouble(buffer, sizeof(buffer), value, precision);
+            if (length < 0) {
+                return false;
+            }
+            
+            double readBack;
+            if (StringBytesToDouble(buffer, length, &readBack) && readBack == value) {
+                memcpy(best, buffer, length);
+                bestLength = length;
+                high = precision;
+            } else {
+                low = precision + 1;
+            }
+        }
+    }
+    
+    if (bestLength < 0) {
+        bestLength = formatDouble(best, sizeof(best), value, 17);
+        if (bestLength < 0) {
+            return false;
+        }
+    }
+    
+    return StringAppendBytes(pStr, best, bestLength);
+}
+
 bool StringPrependCharacter(String *pStr, char ch) {
     return ArrayPrependItem(pStr, &ch);
 }
 
 bool StringPrependString(String *pStr, const String *pNewStr) {
-    return ArrayPrependArray(pStr, pNewStr);
+    return StringInsertString(pStr, 0, pNewStr);
 }
 
 bool StringPrependCString(String *pStr, const char *pNewCStr) {
 	return StringInsertCString(pStr, 0, pNewCStr);
 }
 
+bool StringPrependBytes(String *pStr, const char *pBytes, int length) {
+    return StringInsertBytes(pStr, 0, pBytes, length);
+}
+
 #pragma mark ---Move & Swap
 
 bool StringMoveCharacter(String *pStr, int oldIndex, int newIndex) {
@@ -751,3 +1823,298 @@ bool StringDeleteSubString(String *pStr, int start, int length) {
     
     return true;
 }
+
+#pragma mark - Parse Number
+
+// Optional sign and decimal digits only, return false if not an integer in range
+bool StringToInt64(const String *pStr, int64_t *pOut) {
+    if (!pStr) {
+        return false;
+    }
+    
+    return StringBytesToInt64(pStr->pData, pStr->length, pOut);
+}
+
+// Optional '+' and decimal digits only, return false if not an integer in range
+bool StringToUInt64(const String *pStr, uint64_t *pOut) {
+    if (!pStr) {
+        return false;
+    }
+    
+    return StringBytesToUInt64(pStr->pData, pStr->length, pOut);
+}
+
+// Correctly rounded, decimal with '.' in any locale and optional exponent, "inf", "infinity" or "nan", no blanks, return false if not a number
+bool StringToDouble(const String *pStr, double *pOut) {
+    if (!pStr) {
+        return false;
+    }
+    
+    return StringBytesToDouble(pStr->pData, pStr->length, pOut);
+}
+
+// Optional sign and decimal digits only, return false if not an integer in range
+bool StringBytesToInt64(const char *pBytes, int length, int64_t *pOut) {
+    if ((!pBytes && length > 0) || length < 0 || !pOut) {
+        return false;
+    }
+    
+    const char *pEnd = pBytes + length;
+    bool negative = false;
+    if (length > 0 && (*pBytes == '-' || *pBytes == '+')) {
+        negative = *pBytes == '-';
+        pBytes++;
+    }
+    
+    uint64_t magnitude;
+    if (!parseMagnitude(pBytes, pEnd, negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX, &magnitude)) {
+        return false;
+    }
+    *pOut = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    
+    return true;
+}
+
+// Optional '+' and decimal digits only, return false if not an integer in range
+bool StringBytesToUInt64(const char *pBytes, int length, uint64_t *pOut) {
+    if ((!pBytes && length > 0) || length < 0 || !pOut) {
+        return false;
+    }
+    
+    const char *pEnd = pBytes + length;
+    if (length > 0 && *pBytes == '+') {
+        pBytes++;
+    }
+    
+    return parseMagnitude(pBytes, pEnd, UINT64_MAX, pOut);
+}
+
+// Correctly rounded, decimal with optional exponent, "inf", "infinity" or "nan", no blanks, return false if not a number
+// Up to 19 significant digits with a small exponent are exact in double arithmetic, the rest go to strtod
+bool StringBytesToDouble(const char *pBytes, int length, double *pOut) {
+    static const double powersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    
+    if ((!pBytes && length > 0) || length < 0 || !pOut) {
+        return false;
+    }
+    
+    const char *p = pBytes;
+    const char *pEnd = pBytes + length;
+    bool negative = false;
+    if (p < pEnd && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    
+    if (p < pEnd && (*p | 0x20) >= 'a' && (*p | 0x20) <= 'z') {
+        if (matchWord(p, pEnd, "inf") || matchWord(p, pEnd, "infinity") || matchWord(p, pEnd, "nan")) {
+            return parseDoubleSlow(pBytes, length, pOut);
+        }
+        return false;
+    }
+    
+    // The first 19 significant digits, the value is mantissa * 10^exponent
+    uint64_t mantissa = 0;
+    int digitCount = 0;
+    long long exponent = 0;
+    bool hasDigits = false;
+    // Non-zero digits past the first 19 were dropped
+    bool isInexact = false;
+    bool inFraction = false;
+    
+    for (; p < pEnd; p++) {
+        if (*p == '.' && !inFraction) {
+            inFraction = true;
+            continue;
+        }
+        unsigned digit = (unsigned char)*p - '0';
+        if (digit > 9) {
+            break;
+        }
+        
+        hasDigits = true;
+        if (inFraction) {
+            exponent--;
+        }
+        if (mantissa == 0 && digit == 0) {
+            continue;
+        }
+        if (digitCount < 19) {
+            mantissa = mantissa * 10 + digit;
+            digitCount++;
+        } else {
+            exponent++;
+            isInexact |= digit != 0;
+        }
+    }
+    if (!hasDigits) {
+        return false;
+    }
+    
+    if (p < pEnd && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exponentNegative = false;
+        if (p < pEnd && (*p == '-' || *p == '+')) {
+            exponentNegative = *p == '-';
+            p++;
+        }
+        if (p == pEnd || (unsigned char)*p - '0' > 9) {
+            return false;
+        }
+        
+        long long value = 0;
+        for (; p < pEnd && (unsigned char)*p - '0' <= 9; p++) {
+            // Far beyond the range of double either way
+            if (value < 100000) {
+                value = value * 10 + (*p - '0');
+            }
+        }
+        exponent += exponentNegative ? -value : value;
+    }
+    if (p != pEnd) {
+        return false;
+    }
+    
+    if (mantissa == 0) {
+        *pOut = negative ? -0.0 : 0.0;
+        return true;
+    }
+    
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Both operands are exact and IEEE rounds the one operation correctly
+    if (!isInexact && mantissa <= (uint64_t)1 << 53) {
+        // Move extra powers of 10 into the mantissa while it stays exact
+        while (exponent > 22 && exponent <= 22 + 15 && mantissa <= ((uint64_t)1 << 53) / 10) {
+            mantissa *= 10;
+            exponent--;
+        }
+        
+        if (exponent >= -22 && exponent <= 22) {
+            double value = (double)mantissa;
+            value = exponent < 0 ? value / powersOf10[-exponent] : value * powersOf10[exponent];
+            *pOut = negative ? -value : value;
+            return true;
+        }
+    }
+#endif
+    
+    return parseDoubleSlow(pBytes, length, pOut);
+}
+
+#pragma mark - Character Set
+
+CharSet *CharSetInit() {
+    CharSet *pSet = calloc(1, sizeof(CharSet));
+    
+    return pSet;
+}
+
+CharSet *CharSetInitWithCString(const char *pChs) {
+    if (!pChs) {
+        return NULL;
+    }
+    
+    CharSet *pSet = CharSetInit();
+    if (!pSet) {
+        return NULL;
+    }
+    
+    for (; *pChs; pChs++) {
+        setAdd(pSet, *pChs);
+    }
+    
+    return pSet;
+}
+
+// Accept Array of char
+CharSet *CharSetInitWithArray(const Array *pChsArr) {
+    if (!pChsArr) {
+        return NULL;
+    }
+    
+    CharSet *pSet = CharSetInit();
+    if (!pSet) {
+        return NULL;
+    }
+    
+    for (int i = 0; i < pChsArr->length; i++) {
+        setAdd(pSet, *charAt(pChsArr, i));
+    }
+    
+    return pSet;
+}
+
+// Blank characters, the same as StringTrim uses
+CharSet *CharSetInitWithBlank() {
+    CharSet *pSet = CharSetInit();
+    if (!pSet) {
+        return NULL;
+    }
+    
+    *pSet = blankSet;
+    
+    return pSet;
+}
+
+void CharSetDestroy(CharSet *pSet) {
+    free(pSet);
+}
+
+bool CharSetAddCharacter(CharSet *pSet, char ch) {
+    if (!pSet) {
+        return false;
+    }
+    
+    setAdd(pSet, ch);
+    
+    return true;
+}
+
+bool CharSetRemoveCharacter(CharSet *pSet, char ch) {
+    if (!pSet) {
+        return false;
+    }
+    
+    unsigned char c = (unsigned char)ch;
+    pSet->bits[c >> 5] &= ~((uint32_t)1 << (c & 31));
+    
+    return true;
+}
+
+bool CharSetContains(const CharSet *pSet, char ch) {
+    return pSet ? setContains(pSet, ch) : false;
+}
+
+#pragma mark - String Pieces
+
+void StringPiecesDestroy(StringPieces *pPieces) {
+    free(pPieces);
+}
+
+int StringPiecesCount(const StringPieces *pPieces) {
+    return pPieces ? pPieces->items.length : 0;
+}
+
+// No copy, valid until the pieces are destroyed, don't modify or destroy it, return NULL if index invalid
+const String *StringPiecesItem(const StringPieces *pPieces, int index) {
+    if (!pPieces || index < 0 || index >= pPieces->items.length) {
+        return NULL;
+    }
+    
+    return ((String **)pPieces->items.pData)[index];
+}
+
+// No copy, valid until the pieces are destroyed, return NULL if index invalid
+const char *StringPiecesCString(const StringPieces *pPieces, int index) {
+    const String *pPiece = StringPiecesItem(pPieces, index);
+    
+    return pPiece ? pPiece->pData : NULL;
+}
+
+// Array of String for StringJoin and the like, valid until the pieces are destroyed, don't modify or destroy it
+const Array *StringPiecesArray(const StringPieces *pPieces) {
+    return pPieces ? &pPieces->items : NULL;
+}
@@ -10,33 +10,45 @@
 #define __String__
 
 #include <stdio.h>
+#include <stdint.h>
 #include "DynamicArray.h"
 
 #pragma mark - Type Definition
 
 typedef Array String;
+// Set of characters, reused by trim, split and find functions
+typedef struct _char_set CharSet;
+// Pieces of a split string in one allocation, read only
+typedef struct _string_pieces StringPieces;
 
 #pragma mark - Make String
 
 String *StringInit();
 String *StringInitWithCString(const char *pCStr);
+String *StringInitWithBytes(const char *pBytes, int length);
 String *StringSubString(const String *pStr, int start, int length);
 String *StringCopy(const String *pStr);
 String *StringConcat(const String *pStrA, const String *pStrB);
-// Accept Array of String, join as much as it can(in case of memory insufficient)
+// Accept Array of String, return NULL if memory is not enough
 String *StringJoin(const Array *pStrArr, char separator);
-// Accept Array of C string, join as much as it can(in case of memory insufficient)
+// Accept Array of C string, return NULL if memory is not enough
 String *StringJoinC(const Array *pCStrArr, char separator);
-// Accept Array of String, join as much as it can(in case of memory insufficient), you should free the C string by yourself
+// Accept Array of String, return NULL if memory is not enough
+String *StringJoinWith(const Array *pStrArr, const String *pSeparator);
+// Accept Array of String, return NULL if memory is not enough, you should free the C string by yourself
 char   *CStringJoin(const Array *pStrArr, char separator);
-// Return Array of String
-Array  *StringSplit(const String *pStr, char separator);
-// Return Array of String
-Array  *StringSplitC(const char *pCStr, char separator);
-// Return Array of C string
-Array  *CStringSplit(const String *pStr, char separator);
+// Return the pieces, return NULL if memory is not enough, you should destroy them by yourself
+StringPieces *StringSplit(const String *pStr, char separator);
+// Return the pieces, return NULL if memory is not enough, you should destroy them by yourself
+StringPieces *StringSplitC(const char *pCStr, char separator);
+// Return C strings ending with NULL in one allocation, return NULL if memory is not enough, you should free it by yourself
+char  **CStringSplit(const String *pStr, char separator);
+// Split at any character in pSet, return the pieces, return NULL if memory is not enough, you should destroy them by yourself
+StringPieces *StringSplitCharSet(const String *pStr, const CharSet *pSet);
 
 char *StringCString(const String *pStr);
+// No copy, valid until the string changes, don't free it, return NULL if memory is not enough
+const char *StringCStringView(String *pStr);
 char *StringSubCString(const String *pStr, int start, int length);
 
 #pragma mark - Get Properties
@@ -54,20 +66,63 @@ void StringClear(String *pStr);
 bool StringReverse(String *pStr);
 
 bool StringTrimCharacter(String *pStr, char ch);
+// Accept Array of char
 bool StringTrimCharacters(String *pStr, Array *pChsArr);
+bool StringTrimCharSet(String *pStr, const CharSet *pSet);
+bool StringTrimLeftCharSet(String *pStr, const CharSet *pSet);
+bool StringTrimRightCharSet(String *pStr, const CharSet *pSet);
 // Trim blank characters
 bool StringTrim(String *pStr);
+// Trim blank characters
+bool StringTrimLeft(String *pStr);
+// Trim blank characters
+bool StringTrimRight(String *pStr);
+
+// ASCII letters only, other bytes are unchanged
+bool StringToLowerASCII(String *pStr);
+// ASCII letters only, other bytes are unchanged
+bool StringToUpperASCII(String *pStr);
+// pTable has 256 entries, each character ch becomes pTable[(unsigned char)ch]
+bool StringTranslate(String *pStr, const char *pTable);
 
 #pragma mark ---Do Not Modify
 void StringPrint(const String *pStr);
+// Write the characters only, no '\0' or new line
+bool StringWrite(const String *pStr, FILE *pFile);
+// Write the characters only, no '\0' or new line, retry until all are written
+bool StringWriteFd(const String *pStr, int fd);
 // Return -1 if no such character, return -2 if parameters invalid
 int  StringFindCharacter(const String *pStr, char ch);
+// Find any character in pSet, return -1 if no such character, return -2 if parameters invalid
+int  StringFindCharSet(const String *pStr, const CharSet *pSet);
+// Find any character in pSet, return -1 if no such character, return -2 if parameters invalid
+int  StringFindLastCharSet(const String *pStr, const CharSet *pSet);
 // Return -1 if no such substring, return -2 if parameters invalid
 int  StringFindSubString(const String *pStr, const String *pSub);
 // Return -1 if no such substring, return -2 if parameters invalid
 int  StringFindSubCString(const String *pStr, const char *pCSub);
+// Return -1 if no such substring, return -2 if parameters invalid
+int  StringFindLast(const String *pStr, const String *pSub);
+// Return Array of int, the indexes of non-overlapping occurrences, the length of pSub should be greater than 0
+Array *StringFindAll(const String *pStr, const String *pSub);
+// Count non-overlapping occurrences, the length of pSub should be greater than 0, return -2 if parameters invalid
+int  StringCount(const String *pStr, const String *pSub);
+// Bytes are compared as unsigned char, a proper prefix orders first
 // Accept only non-NULL parameters (Return 0 if any parameter is invalid)
 int  StringCompare(const String *pStrA, const String *pStrB);
+// Fold ASCII letters only
+// Accept only non-NULL parameters (Return 0 if any parameter is invalid)
+int  StringCompareCaseInsensitive(const String *pStrA, const String *pStrB);
+bool StringEquals(const String *pStrA, const String *pStrB);
+// Fold ASCII letters only
+bool StringEqualsCaseInsensitive(const String *pStrA, const String *pStrB);
+// Fast 64-bit non-cryptographic hash, equal strings have equal hashes
+uint64_t StringHash(const String *pStr);
+uint64_t StringHashBytes(const void *pData, int length);
+// Reject overlong forms, surrogates and code points above U+10FFFF
+bool StringValidateUTF8(const String *pStr);
+// Count of code points in valid UTF-8, in fact the count of bytes that are not 0x80 to 0xBF, return -2 if parameters invalid
+int  StringUTF8Length(const String *pStr);
 
 #pragma mark - Manipulate Single Character
 
@@ -85,11 +140,23 @@ bool StringReplaceCharacterAWithB(String *pStr, int aIndex, int bIndex);
 // Perhaps increase the length of the string; Example: replace("I love you",7,"shit") will make "I love shit"
 bool StringReplaceSubString(String *pStr, int index, const String *pNewSub);
 bool StringReplaceSubCString(String *pStr, int index, const char *pNewCSub);
+// Copy a shared buffer only if oldCh is found
+bool StringReplaceAllCharacter(String *pStr, char oldCh, char newCh);
+// Misspelled name kept for existing callers, the same as StringReplaceAllCharacter
 bool StringReplaceAllCharater(String *pStr, char oldCh, char newCh);
 // The length of pOldSub should be greater than 0
 bool StringReplaceAllSubString(String *pStr, const String *pOldSub, const String *pNewSub);
 // The length of pOldCSub should be greater than 0
 bool StringReplaceAllSubCString(String *pStr, const char *pOldCSub, const char *pNewCSub);
+// Replace at most maxCount occurrences from the beginning, the length of pOldSub should be greater than 0
+bool StringReplaceNSubString(String *pStr, const String *pOldSub, const String *pNewSub, int maxCount);
+// Replace at most maxCount occurrences from the beginning, the length of pOldCSub should be greater than 0
+bool StringReplaceNSubCString(String *pStr, const char *pOldCSub, const char *pNewCSub, int maxCount);
+// Accept two Array of String of the same length, replace every pOldSubArr[i] with pNewSubArr[i] in one pass,
+// the leftmost occurrence wins, and the earlier pair wins at the same index. The old ones should not be empty
+bool StringReplaceAllSubStrings(String *pStr, const Array *pOldSubArr, const Array *pNewSubArr);
+// Same as StringReplaceAllSubStrings, but accept two Array of C string
+bool StringReplaceAllSubCStrings(String *pStr, const Array *pOldCSubArr, const Array *pNewCSubArr);
 
 #pragma mark ---Insert
 // Accept index range from 0 to pStr->length
@@ -98,14 +165,22 @@ bool StringInsertCharacter(String *pStr, int index, char ch);
 bool StringInsertString(String *pStr, int index, const String *pNewStr);
 // Accept index range from 0 to pStr->length
 bool StringInsertCString(String *pStr, int index, const char *pNewCStr);
+// Accept index range from 0 to pStr->length
+bool StringInsertBytes(String *pStr, int index, const char *pBytes, int length);
 
 #pragma mark ---Append & Prepend
 bool StringAppendCharacter(String *pStr, char ch);
 bool StringAppendString(String *pStr, const String *pNewStr);
 bool StringAppendCString(String *pStr, const char *pNewCStr);
+bool StringAppendBytes(String *pStr, const char *pBytes, int length);
+bool StringAppendInt64(String *pStr, int64_t value);
+bool StringAppendUInt64(String *pStr, uint64_t value);
+// Integers below 1e15 in full, others in the fewest %g digits that read back as the same value, with '.' in any locale
+bool StringAppendDouble(String *pStr, double value);
 bool StringPrependCharacter(String *pStr, char ch);
 bool StringPrependString(String *pStr, const String *pNewStr);
 bool StringPrependCString(String *pStr, const char *pNewCStr);
+bool StringPrependBytes(String *pStr, const char *pBytes, int length);
 
 #pragma mark ---Move & Swap
 bool StringMoveCharacter(String *pStr, int oldIndex, int newIndex);
@@ -117,4 +192,40 @@ bool StringDeleteFirstCharacter(String *pStr);
 bool StringDeleteLastCharacter(String *pStr);
 bool StringDeleteSubString(String *pStr, int start, int length);
 
+#pragma mark - Parse Number
+
+// Optional sign and decimal digits only, return false if not an integer in range
+bool StringToInt64(const String *pStr, int64_t *pOut);
+// Optional '+' and decimal digits only, return false if not an integer in range
+bool StringToUInt64(const String *pStr, uint64_t *pOut);
+// Correctly rounded, decimal with '.' in any locale and optional exponent, "inf", "infinity" or "nan", no blanks, return false if not a number
+bool StringToDouble(const String *pStr, double *pOut);
+bool StringBytesToInt64(const char *pBytes, int length, int64_t *pOut);
+bool StringBytesToUInt64(const char *pBytes, int length, uint64_t *pOut);
+bool StringBytesToDouble(const char *pBytes, int length, double *pOut);
+
+#pragma mark - Character Set
+
+CharSet *CharSetInit();
+CharSet *CharSetInitWithCString(const char *pChs);
+// Accept Array of char
+CharSet *CharSetInitWithArray(const Array *pChsArr);
+// Blank characters, the same as StringTrim uses
+CharSet *CharSetInitWithBlank();
+void CharSetDestroy(CharSet *pSet);
+bool CharSetAddCharacter(CharSet *pSet, char ch);
+bool CharSetRemoveCharacter(CharSet *pSet, char ch);
+bool CharSetContains(const CharSet *pSet, char ch);
+
+#pragma mark - String Pieces
+
+void StringPiecesDestroy(StringPieces *pPieces);
+int  StringPiecesCount(const StringPieces *pPieces);
+// No copy, valid until the pieces are destroyed, don't modify or destroy it, return NULL if index invalid
+const String *StringPiecesItem(const StringPieces *pPieces, int index);
+// No copy, valid until the pieces are destroyed, return NULL if index invalid
+const char   *StringPiecesCString(const StringPieces *pPieces, int index);
+// Array of String for StringJoin and the like, valid until the pieces are destroyed, don't modify or destroy it
+const Array  *StringPiecesArray(const StringPieces *pPieces);
+
 #endif
@@ -0,0 +1,304 @@
+//
+//  StringBuilder.c
+//  DataStructure
+//
+
+#include "StringBuilder.h"
+#include <limits.h>
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Builder Structure
+
+struct _string_builder {
+    String *pStr;
+};
+
+#pragma mark - Inner Function
+
+// Make room for extra more characters, double the capacity when growing
+static bool builderGrow(StringBuilder *pBuilder, int extra) {
+    String *pStr = pBuilder->pStr;
+    // One more for the '\0' vsnprintf and StringCStringView write
+    if (extra < 0 || extra >= INT_MAX - pStr->length) {
+        return false;
+    }
+    
+    int minCapacity = pStr->length + extra + 1;
+    int capacity = pStr->capacity;
+    if (minCapacity > capacity) {
+        capacity = capacity < 16 ? 16 : capacity;
+        while (capacity < minCapacity) {
+            capacity = capacity > INT_MAX / 2 ? minCapacity : capacity * 2;
+        }
+    }
+    
+    // Reserving also unshares the buffer, which a copy of StringBuilderString may share
+    return ArrayReserve(pStr, capacity);
+}
+
+#pragma mark - Make Builder
+
+StringBuilder *StringBuilderInit() {
+    return StringBuilderInitWithCapacity(0);
+}
+
+StringBuilder *StringBuilderInitWithCapacity(int capacity) {
+    if (capacity < 0) {
+        return NULL;
+    }
+    
+    StringBuilder *pBuilder = malloc(sizeof(StringBuilder));
+    if (!pBuilder) {
+        return NULL;
+    }
+    
+    pBuilder->pStr = StringInit();
+    if (!pBuilder->pStr || !ArrayReserve(pBuilder->pStr, capacity)) {
+        StringDestroy(pBuilder->pStr);
+        free(pBuilder);
+        return NULL;
+    }
+    
+    return pBuilder;
+}
+
+void StringBuilderDestroy(StringBuilder *pBuilder) {
+    if (!pBuilder) {
+        return;
+    }
+    
+    StringDestroy(pBuilder->pStr);
+    free(pBuilder);
+}
+
+// Destroy the builder and return the built string, which the caller should destroy
+String *StringBuilderFinish(StringBuilder *pBuilder) {
+    if (!pBuilder) {
+        return NULL;
+    }
+    
+    String *pStr = pBuilder->pStr;
+    free(pBuilder);
+    
+    return pStr;
+}
+
+#pragma mark - Get Properties
+
+int StringBuilderLength(const StringBuilder *pBuilder) {
+    return pBuilder ? pBuilder->pStr->length : 0;
+}
+
+int StringBuilderCapacity(const StringBuilder *pBuilder) {
+    return pBuilder ? pBuilder->pStr->capacity : 0;
+}
+
+// Valid until the next change to the builder, don't modify or destroy it
+const String *StringBuilderString(const StringBuilder *pBuilder) {
+    return pBuilder ? pBuilder->pStr : NULL;
+}
+
+// No copy, valid until the next change to the builder, return NULL if memory is not enough
+const char *StringBuilderCStringView(StringBuilder *pBuilder) {
+    return pBuilder ? StringCStringView(pBuilder->pStr) : NULL;
+}
+
+#pragma mark - Operation
+
+// Make room for at least capacity characters in total
+bool StringBuilderReserve(StringBuilder *pBuilder, int capacity) {
+    if (!pBuilder) {
+        return false;
+    }
+    
+    return ArrayReserve(pBuilder->pStr, capacity);
+}
+
+void StringBuilderClear(StringBuilder *pBuilder) {
+    if (!pBuilder) {
+        return;
+    }
+    
+    // Keep the buffer for reuse
+    pBuilder->pStr->length = 0;
+}
+
+#pragma mark - Append
+
+bool StringBuilderAppendCharacter(StringBuilder *pBuilder, char ch) {
+    if (!pBuilder || !builderGrow(pBuilder, 1)) {
+        return false;
+    }
+    
+    String *pStr = pBuilder->pStr;
+    ((char *)pStr->pData)[pStr->length++] = ch;
+    
+    return true;
+}
+
+bool StringBuilderAppendString(StringBuilder *pBuilder, const String *pStr) {
+    if (!pStr) {
+        return false;
+    }
+    
+    return StringBuilderAppendBytes(pBuilder, pStr->pData, pStr->length);
+}
+
+bool StringBuilderAppendCString(StringBuilder *pBuilder, const char *pCStr) {
+    if (!pCStr) {
+        return false;
+    }
+    
+    size_t length = strlen(pCStr);
+    if (length > INT_MAX) {
+        return false;
+    }
+    
+    return StringBuilderAppendBytes(pBuilder, pCStr, (int)length);
+}
+
+bool StringBuilderAppendBytes(StringBuilder *pBuilder, const char *pBytes, int length) {
+    if (!pBuilder || length < 0 || (!pBytes && length > 0)) {
+        return false;
+    }
+    
+    String *pStr = pBuilder->pStr;
+    if (length > 0 && pBytes >= (char *)pStr->pData && pBytes < (char *)pStr->pData + pStr->length) {
+        // Appending part of itself, the buffer may move
+        int offset = (int)(pBytes - (char *)pStr->pData);
+        if (!builderGrow(pBuilder, length)) {
+            return false;
+        }
+        pBytes = (char *)pStr->pData + offset;
+    } else if (!builderGrow(pBuilder, length)) {
+        return false;
+    }
+    
+    if (length > 0) {
+        memcpy((char *)pStr->pData + pStr->length, pBytes, length);
+        pStr->length += length;
+    }
+    
+    return true;
+}
+
+// printf style straight into the spare capacity, no argument may point into the builder's own string,
+// return false if the format fails or memory is not enough
+bool StringBuilderAppendFormat(StringBuilder *pBuilder, const char *pFormat, ...) {
+    va_list args;
+    va_start(args, pFormat);
+    bool result = StringBuilderAppendFormatV(pBuilder, pFormat, args);
+    va_end(args);
+    
+    return result;
+}
+
+bool StringBuilderAppendFormatV(StringBuilder *pBuilder, const char *pFormat, va_list args) {
+    if (!pBuilder || !pFormat) {
+        return false;
+    }
+    
+    // Growing keeps room for the '\0' vsnprintf writes
+    if (!builderGrow(pBuilder, 0)) {
+        return false;
+    }
+    
+    String *pStr = pBuilder->pStr;
+    int space = pStr->capacity - pStr->length;
+    
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    int length = vsnprintf((char *)pStr->pData + pStr->length, space, pFormat, argsCopy);
+    va_end(argsCopy);
+    
+    if (length < 0) {
+        return false;
+    }
+    
+    if (length >= space) {
+        // Didn't fit, grow once and format again
+        if (!builderGrow(pBuilder, length)) {
+            return false;
+        }
+        
+        space = pStr->capacity - pStr->length;
+        va_copy(argsCopy, args);
+        length = vsnprintf((char *)pStr->pData + pStr->length, space, pFormat, argsCopy);
+        va_end(argsCopy);
+        
+        if (length < 0 || length >= space) {
+            return false;
+        }
+    }
+    
+    pStr->length += length;
+    
+    return true;
+}
+
+// Accept Array of String, pSeparator may be NULL, neither may be the builder's own string
+bool StringBuilderAppendJoin(StringBuilder *pBuilder, const Array *pStrArr, const String *pSeparator) {
+    if (!pBuilder || !pStrArr || ArrayItemSize(pStrArr) != sizeof(String *)) {
+        return false;
+    }
+    
+    const String **ppPieces = pStrArr->pData;
+    if (pSeparator == pBuilder->pStr) {
+        return false;
+    }
+    int sepLength = pSeparator ? pSeparator->length : 0;
+    
+    // Size it exactly first, so the buffer grows at most once
+    long long total = pStrArr->length > 0 ? (long long)sepLength * (pStrArr->length - 1) : 0;
+    for (int i = 0; i < pStrArr->length && total <= INT_MAX; i++) {
+        // The builder's own string would grow while being copied
+        if (ppPieces[i] == pBuilder->pStr) {
+            return false;
+        }
+        total += ppPieces[i] ? ppPieces[i]->length : 0;
+    }
+    if (total > INT_MAX || !builderGrow(pBuilder, (int)total)) {
+        return false;
+    }
+    
+    String *pStr = pBuilder->pStr;
+    for (int i = 0; i < pStrArr->length; i++) {
+        if (i > 0 && sepLength > 0) {
+            memcpy((char *)pStr->pData + pStr->length, pSeparator->pData, sepLength);
+            pStr->length += sepLength;
+        }
+        if (ppPieces[i] && ppPieces[i]->length > 0) {
+            memcpy((char *)pStr->pData + pStr->length, ppPieces[i]->pData, ppPieces[i]->length);
+            pStr->length += ppPieces[i]->length;
+        }
+    }
+    
+    return true;
+}
+
+bool StringBuilderAppendInt(StringBuilder *pBuilder, long long value) {
+    if (!pBuilder) {
+        return false;
+    }
+    
+    return StringAppendInt64(pBuilder->pStr, value);
+}
+
+// Integers below 1e15 in full, others in the fewest %g digits that read back as the same value, with '.' in any locale
+bool StringBuilderAppendDouble(StringBuilder *pBuilder, double value) {
+    if (!pBuilder) {
+        return false;
+    }
+    
+    return StringAppendDouble(pBuilder->pStr, value);
+}
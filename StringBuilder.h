@@ -0,0 +1,59 @@
+//
+//  StringBuilder.h
+//  DataStructure
+//
+
+#ifndef __StringBuilder__
+#define __StringBuilder__
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "String.h"
+
+// Builds a String by appending, the buffer grows geometrically and formatted text is written into spare capacity.
+// Finish hands the buffer to a String without copying.
+
+#pragma mark - Type Definition
+
+typedef struct _string_builder StringBuilder;
+
+#pragma mark - Make Builder
+
+StringBuilder *StringBuilderInit();
+StringBuilder *StringBuilderInitWithCapacity(int capacity);
+void StringBuilderDestroy(StringBuilder *pBuilder);
+// Destroy the builder and return the built string, which the caller should destroy
+String *StringBuilderFinish(StringBuilder *pBuilder);
+
+#pragma mark - Get Properties
+
+int StringBuilderLength(const StringBuilder *pBuilder);
+int StringBuilderCapacity(const StringBuilder *pBuilder);
+// Valid until the next change to the builder, don't modify or destroy it
+const String *StringBuilderString(const StringBuilder *pBuilder);
+// No copy, valid until the next change to the builder, return NULL if memory is not enough
+const char *StringBuilderCStringView(StringBuilder *pBuilder);
+
+#pragma mark - Operation
+
+// Make room for at least capacity characters in total
+bool StringBuilderReserve(StringBuilder *pBuilder, int capacity);
+void StringBuilderClear(StringBuilder *pBuilder);
+
+#pragma mark - Append
+
+bool StringBuilderAppendCharacter(StringBuilder *pBuilder, char ch);
+bool StringBuilderAppendString(StringBuilder *pBuilder, const String *pStr);
+bool StringBuilderAppendCString(StringBuilder *pBuilder, const char *pCStr);
+bool StringBuilderAppendBytes(StringBuilder *pBuilder, const char *pBytes, int length);
+// printf style straight into the spare capacity, no argument may point into the builder's own string,
+// return false if the format fails or memory is not enough
+bool StringBuilderAppendFormat(StringBuilder *pBuilder, const char *pFormat, ...);
+bool StringBuilderAppendFormatV(StringBuilder *pBuilder, const char *pFormat, va_list args);
+// Accept Array of String, pSeparator may be NULL, neither may be the builder's own string
+bool StringBuilderAppendJoin(StringBuilder *pBuilder, const Array *pStrArr, const String *pSeparator);
+bool StringBuilderAppendInt(StringBuilder *pBuilder, long long value);
+// Integers below 1e15 in full, others in the fewest %g digits that read back as the same value, with '.' in any locale
+bool StringBuilderAppendDouble(StringBuilder *pBuilder, double value);
+
+#endif
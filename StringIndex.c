@@ -0,0 +1,633 @@
+//
+//  StringIndex.c
+//  DataStructure
+//
+
+#include "StringIndex.h"
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+#define INDEX_FILE_MAGIC "StrIdx01"
+#define INDEX_FILE_BYTE_ORDER 0x01020304u
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Index Structure
+
+struct _string_index {
+    // Shares the buffer of the String the index is built from, NULL if loaded
+    String *pStr;
+    const unsigned char *pText;
+    int length;
+    // pSuffixes[i] is where the i-th smallest suffix starts,
+    // pLCP[i] is the length of the common prefix of suffixes i - 1 and i, pLCP[0] is 0
+    const int *pSuffixes;
+    const int *pLCP;
+    // Allocated arrays of a built index, NULL if loaded
+    int *pOwnedArrays;
+    // Whole file of a loaded index, mapped or read into memory
+    void *pFile;
+    size_t fileSize;
+    bool isMapped;
+};
+
+// Followed by the text, padding to a multiple of 4, the suffix array and the LCP array
+typedef struct _index_file_header {
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t intSize;
+    int64_t length;
+} IndexFileHeader;
+
+#pragma mark - Inner Function
+
+// Bucket sort the LMS suffixes in order, then induce the L and S suffixes from them
+static void induce(const int *s, int n, int upper, const bool *pIsS, const int *pSumL, const int *pSumS, int *pBuckets,
+                   const int *pLMS, int lmsCount, int *pSA) {
+    for (int i = 0; i < n; i++) {
+        pSA[i] = -1;
+    }
+    
+    memcpy(pBuckets, pSumS, (upper + 1) * sizeof(int));
+    for (int i = 0; i < lmsCount; i++) {
+        int d = pLMS[i];
+        if (d != n) {
+            pSA[pBuckets[s[d]]++] = d;
+        }
+    }
+    
+    memcpy(pBuckets, pSumL, (upper + 1) * sizeof(int));
+    pSA[pBuckets[s[n - 1]]++] = n - 1;
+    for (int i = 0; i < n; i++) {
+        int v = pSA[i];
+        if (v >= 1 && !pIsS[v - 1]) {
+            pSA[pBuckets[s[v - 1]]++] = v - 1;
+        }
+    }
+    
+    memcpy(pBuckets, pSumL, (upper + 1) * sizeof(int));
+    for (int i = n - 1; i >= 0; i--) {
+        int v = pSA[i];
+        if (v >= 1 && pIsS[v - 1]) {
+            pSA[--pBuckets[s[v - 1] + 1]] = v - 1;
+        }
+    }
+}
+
+// SA-IS, sort the suffixes of s[0, n) with values from 0 to upper into pSA, return false if memory is not enough
+static bool suffixArray(const int *s, int n, int upper, int *pSA) {
+    if (n == 0) {
+        return true;
+    }
+    if (n == 1) {
+        pSA[0] = 0;
+        return true;
+    }
+    if (n == 2) {
+        pSA[0] = s[0] < s[1] ? 0 : 1;
+        pSA[1] = s[0] < s[1] ? 1 : 0;
+        return true;
+    }
+    
+    bool isDone = false;
+    bool *pIsS = malloc(n * sizeof(bool));
+    int *pSumL = calloc(upper + 1, sizeof(int));
+    int *pSumS = calloc(upper + 1, sizeof(int));
+    int *pBuckets = malloc((upper + 1) * sizeof(int));
+    int *pLMSMap = malloc((n + 1) * sizeof(int));
+    int *pLMSArrays = NULL;
+    if (!pIsS || !pSumL || !pSumS || !pBuckets || !pLMSMap) {
+        goto exit;
+    }
+    
+    // A suffix is S if it is smaller than the one after it, the last suffix is L
+    pIsS[n - 1] = false;
+    for (int i = n - 2; i >= 0; i--) {
+        pIsS[i] = s[i] == s[i + 1] ? pIsS[i + 1] : s[i] < s[i + 1];
+    }
+    
+    // Start of the S part and of the L part of each bucket
+    for (int i = 0; i < n; i++) {
+        if (!pIsS[i]) {
+            pSumS[s[i]]++;
+        } else {
+            pSumL[s[i] + 1]++;
+        }
+    }
+    for (int i = 0; i <= upper; i++) {
+        pSumS[i] += pSumL[i];
+        if (i < upper) {
+            pSumL[i + 1] += pSumS[i];
+        }
+    }
+    
+    // LMS positions are S with L before them
+    int m = 0;
+    for (int i = 0; i <= n; i++) {
+        pLMSMap[i] = -1;
+    }
+    for (int i = 1; i < n; i++) {
+        if (!pIsS[i - 1] && pIsS[i]) {
+            pLMSMap[i] = m++;
+        }
+    }
+    
+    // Without LMS suffixes the L suffixes induce the whole order
+    if (m == 0) {
+        induce(s, n, upper, pIsS, pSumL, pSumS, pBuckets, NULL, 0, pSA);
+        isDone = true;
+        goto exit;
+    }
+    
+    pLMSArrays = malloc(4 * (size_t)m * sizeof(int));
+    if (!pLMSArrays) {
+        goto exit;
+    }
+    int *pLMS = pLMSArrays;
+    int *pSortedLMS = pLMS + m;
+    int *pReduced = pSortedLMS + m;
+    int *pReducedSA = pReduced + m;
+    
+    for (int i = 1, j = 0; i < n; i++) {
+        if (!pIsS[i - 1] && pIsS[i]) {
+            pLMS[j++] = i;
+        }
+    }
+    
+    induce(s, n, upper, pIsS, pSumL, pSumS, pBuckets, pLMS, m, pSA);
+    
+    // Name the LMS substrings in sorted order, equal substrings get equal names
+    int j = 0;
+    for (int i = 0; i < n; i++) {
+        if (pLMSMap[pSA[i]] != -1) {
+            pSortedLMS[j++] = pSA[i];
+        }
+    }
+    
+    int reducedUpper = 0;
+    pReduced[pLMSMap[pSortedLMS[0]]] = 0;
+    for (int i = 1; i < m; i++) {
+        int l = pSortedLMS[i - 1], r = pSortedLMS[i];
+        int endL = pLMSMap[l] + 1 < m ? pLMS[pLMSMap[l] + 1] : n;
+        int endR = pLMSMap[r] + 1 < m ? pLMS[pLMSMap[r] + 1] : n;
+        bool isSame = true;
+        if (endL - l != endR - r) {
+            isSame = false;
+        } else {
+            while (l < endL && s[l] == s[r]) {
+                l++;
+                r++;
+            }
+            if (l == n || s[l] != s[r]) {
+                isSame = false;
+            }
+        }
+        if (!isSame) {
+            reducedUpper++;
+        }
+        pReduced[pLMSMap[pSortedLMS[i]]] = reducedUpper;
+    }
+    
+    // Sort the LMS suffixes by sorting the string of their names, then induce again
+    if (!suffixArray(pReduced, m, reducedUpper, pReducedSA)) {
+        goto exit;
+    }
+    for (int i = 0; i < m; i++) {
+        pSortedLMS[i] = pLMS[pReducedSA[i]];
+    }
+    induce(s, n, upper, pIsS, pSumL, pSumS, pBuckets, pSortedLMS, m, pSA);
+    isDone = true;
+    
+exit:
+    free(pIsS);
+    free(pSumL);
+    free(pSumS);
+    free(pBuckets);
+    free(pLMSMap);
+    free(pLMSArrays);
+    
+    return isDone;
+}
+
+// Kasai, pLCP[i] is the common prefix length of suffixes i - 1 and i in pSA, return false if memory is not enough
+static bool lcpArray(const unsigned char *pText, int n, const int *pSA, int *pLCP) {
+    if (n == 0) {
+        return true;
+    }
+    
+    int *pRank = malloc(n * sizeof(int));
+    if (!pRank) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        pRank[pSA[i]] = i;
+    }
+    
+    // The common prefix shrinks by at most one from each suffix to the next one in the text
+    pLCP[0] = 0;
+    int h = 0;
+    for (int i = 0; i < n; i++) {
+        if (h > 0) {
+            h--;
+        }
+        if (pRank[i] == 0) {
+            h = 0;
+            continue;
+        }
+        int j = pSA[pRank[i] - 1];
+        while (i + h < n && j + h < n && pText[i + h] == pText[j + h]) {
+            h++;
+        }
+        pLCP[pRank[i]] = h;
+    }
+    
+    free(pRank);
+    
+    return true;
+}
+
+// Compare the suffix with the pattern, a suffix the pattern is a prefix of counts as equal
+static int compareSuffix(const StringIndex *pIndex, int suffix, const unsigned char *pSub, int m) {
+    int available = pIndex->length - suffix;
+    int result = memcmp(pIndex->pText + suffix, pSub, available < m ? available : m);
+    if (result != 0) {
+        return result;
+    }
+    
+    return available < m ? -1 : 0;
+}
+
+// The range [*pFirst, *pLast) of suffixes starting with the pattern
+static void suffixRange(const StringIndex *pIndex, const String *pSub, int *pFirst, int *pLast) {
+    const unsigned char *pData = pSub->pData;
+    int m = pSub->length;
+    
+    int low = 0, high = pIndex->length;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (compareSuffix(pIndex, pIndex->pSuffixes[middle], pData, m) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    *pFirst = low;
+    
+    high = pIndex->length;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (compareSuffix(pIndex, pIndex->pSuffixes[middle], pData, m) <= 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    *pLast = low;
+}
+
+static int compareInt(const void *pA, const void *pB) {
+    int a = *(const int *)pA;
+    int b = *(const int *)pB;
+    return (a > b) - (a < b);
+}
+
+static StringIndex *indexInit() {
+    StringIndex *pIndex = malloc(sizeof(StringIndex));
+    if (!pIndex) {
+        return NULL;
+    }
+    
+    pIndex->pStr = NULL;
+    pIndex->pText = NULL;
+    pIndex->length = 0;
+    pIndex->pSuffixes = NULL;
+    pIndex->pLCP = NULL;
+    pIndex->pOwnedArrays = NULL;
+    pIndex->pFile = NULL;
+    pIndex->fileSize = 0;
+    pIndex->isMapped = false;
+    
+    return pIndex;
+}
+
+// Offset of the suffix array in a file of a text of the given length
+static size_t suffixesOffset(size_t length) {
+    return (sizeof(IndexFileHeader) + length + 3) / 4 * 4;
+}
+
+// Read the whole file into memory, for files that can't be mapped
+static bool readFile(FILE *pFile, void **ppData, size_t *pSize) {
+    size_t capacity = 1 << 16;
+    size_t size = 0;
+    char *pData = malloc(capacity);
+    if (!pData) {
+        return false;
+    }
+    
+    for (;;) {
+        size += fread(pData + size, 1, capacity - size, pFile);
+        if (size < capacity) {
+            break;
+        }
+        char *pNewData = capacity <= SIZE_MAX / 2 ? realloc(pData, capacity * 2) : NULL;
+        if (!pNewData) {
+            free(pData);
+            return false;
+        }
+        pData = pNewData;
+        capacity *= 2;
+    }
+    
+    if (ferror(pFile)) {
+        free(pData);
+        return false;
+    }
+    
+    *ppData = pData;
+    *pSize = size;
+    
+    return true;
+}
+
+#pragma mark - Make Index
+
+// The index shares pStr's buffer, changes to pStr don't affect it, return NULL if memory is not enough
+StringIndex *StringIndexInit(const String *pStr) {
+    if (!pStr || pStr->length > INT_MAX / 2) {
+        return NULL;
+    }
+    
+    StringIndex *pIndex = indexInit();
+    if (!pIndex) {
+        return NULL;
+    }
+    
+    int n = pStr->length;
+    int *pArrays = malloc((n > 0 ? 2 * (size_t)n : 1) * sizeof(int));
+    if (!pArrays) {
+        StringIndexDestroy(pIndex);
+        return NULL;
+    }
+    // Owned from here on, destroying the index frees it
+    pIndex->pOwnedArrays = pArrays;
+    pIndex->pSuffixes = pArrays;
+    pIndex->pLCP = pArrays + n;
+    
+    // Changes to pStr copy its buffer first, so the shared text stays the same
+    pIndex->pStr = StringCopy(pStr);
+    if (!pIndex->pStr) {
+        StringIndexDestroy(pIndex);
+        return NULL;
+    }
+    pIndex->pText = pIndex->pStr->pData;
+    pIndex->length = n;
+    
+    // An empty text has no suffixes to sort
+    if (n == 0) {
+        return pIndex;
+    }
+    
+    int *pSymbols = malloc((size_t)n * sizeof(int));
+    if (!pSymbols) {
+        StringIndexDestroy(pIndex);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        pSymbols[i] = pIndex->pText[i];
+    }
+    
+    bool isBuilt = suffixArray(pSymbols, n, UCHAR_MAX, pArrays) && lcpArray(pIndex->pText, n, pArrays, pArrays + n);
+    free(pSymbols);
+    
+    if (!isBuilt) {
+        StringIndexDestroy(pIndex);
+        return NULL;
+    }
+    
+    return pIndex;
+}
+
+// Map the file if possible, read it otherwise, return NULL if it is not a saved index of this platform
+StringIndex *StringIndexLoad(const char *pPath) {
+    if (!pPath) {
+        return NULL;
+    }
+    
+    StringIndex *pIndex = indexInit();
+    if (!pIndex) {
+        return NULL;
+    }
+    
+#ifndef _WIN32
+    int fd;
+    do {
+        fd = open(pPath, O_RDONLY);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        StringIndexDestroy(pIndex);
+        return NULL;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 && (unsigned long long)info.st_size <= SIZE_MAX) {
+        void *pMap = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pMap != MAP_FAILED) {
+            pIndex->pFile = pMap;
+            pIndex->fileSize = (size_t)info.st_size;
+            pIndex->isMapped = true;
+        }
+    }
+    close(fd);
+#endif
+    
+    if (!pIndex->pFile) {
+        FILE *pFile = fopen(pPath, "rb");
+        bool isRead = pFile && readFile(pFile, &pIndex->pFile, &pIndex->fileSize);
+        if (pFile) {
+            fclose(pFile);
+        }
+        if (!isRead) {
+            StringIndexDestroy(pIndex);
+            return NULL;
+        }
+    }
+    
+    const IndexFileHeader *pHeader = pIndex->pFile;
+    if (pIndex->fileSize < sizeof(IndexFileHeader) || memcmp(pHeader->magic, INDEX_FILE_MAGIC, sizeof(pHeader->magic)) != 0 ||
+        pHeader->byteOrder != INDEX_FILE_BYTE_ORDER || pHeader->intSize != sizeof(int) ||
+        pHeader->length < 0 || pHeader->length > INT_MAX / 2) {
+        StringIndexDestroy(pIndex);
+        return NULL;
+    }
+    
+    size_t length = (size_t)pHeader->length;
+    size_t offset = suffixesOffset(length);
+    if (pIndex->fileSize != offset + 2 * length * sizeof(int)) {
+        StringIndexDestroy(pIndex);
+        return NULL;
+    }
+    
+    const char *pBase = pIndex->pFile;
+    pIndex->pText = (const unsigned char *)(pBase + sizeof(IndexFileHeader));
+    pIndex->length = (int)length;
+    pIndex->pSuffixes = (const int *)(pBase + offset);
+    pIndex->pLCP = pIndex->pSuffixes + length;
+    
+    return pIndex;
+}
+
+void StringIndexDestroy(StringIndex *pIndex) {
+    if (!pIndex) {
+        return;
+    }
+    
+#ifndef _WIN32
+    if (pIndex->isMapped) {
+        munmap(pIndex->pFile, pIndex->fileSize);
+    } else
+#endif
+    {
+        free(pIndex->pFile);
+    }
+    
+    free(pIndex->pOwnedArrays);
+    StringDestroy(pIndex->pStr);
+    free(pIndex);
+}
+
+#pragma mark - Get Properties
+
+// Length of the text
+int StringIndexLength(const StringIndex *pIndex) {
+    return pIndex ? pIndex->length : 0;
+}
+
+#pragma mark - Query
+
+bool StringIndexContains(const StringIndex *pIndex, const String *pSub) {
+    return StringIndexCount(pIndex, pSub) > 0;
+}
+
+// Count of occurrences including overlapping ones, the empty string occurs length + 1 times, return -2 if parameters invalid
+int StringIndexCount(const StringIndex *pIndex, const String *pSub) {
+    if (!pIndex || !pSub) {
+        return -2;
+    }
+    
+    // The empty string occurs before every character and at the end
+    if (pSub->length == 0) {
+        return pIndex->length + 1;
+    }
+    
+    int first, last;
+    suffixRange(pIndex, pSub, &first, &last);
+    
+    return last - first;
+}
+
+// Return Array of int, the indexes of all occurrences including overlapping ones in ascending order,
+// 0 to length for the empty string, return NULL if parameters invalid or memory is not enough
+Array *StringIndexLocate(const StringIndex *pIndex, const String *pSub) {
+    if (!pIndex || !pSub) {
+        return NULL;
+    }
+    
+    // The empty string occurs before every character and at the end, as StringIndexCount counts it
+    int first = 0, last = 0;
+    int count = pIndex->length + 1;
+    if (pSub->length > 0) {
+        suffixRange(pIndex, pSub, &first, &last);
+        count = last - first;
+    }
+    
+    Array *pIndexes = ArrayInit(sizeof(int));
+    if (!pIndexes || !ArrayReserve(pIndexes, count)) {
+        ArrayDestroy(pIndexes);
+        return NULL;
+    }
+    
+    if (pSub->length == 0) {
+        int *pOut = pIndexes->pData;
+        for (int i = 0; i < count; i++) {
+            pOut[i] = i;
+        }
+    } else if (count > 0) {
+        memcpy(pIndexes->pData, pIndex->pSuffixes + first, count * sizeof(int));
+        qsort(pIndexes->pData, count, sizeof(int), compareInt);
+    }
+    pIndexes->length = count;
+    
+    return pIndexes;
+}
+
+// Return the longest substring occurring at least twice, empty if there is none, return NULL if parameters invalid
+String *StringIndexLongestRepeatedSubString(const StringIndex *pIndex) {
+    if (!pIndex) {
+        return NULL;
+    }
+    
+    // The longest common prefix of any two suffixes is between neighbours in the suffix array
+    int best = 0;
+    for (int i = 1; i < pIndex->length; i++) {
+        if (pIndex->pLCP[i] > pIndex->pLCP[best]) {
+            best = i;
+        }
+    }
+    
+    if (pIndex->length == 0 || pIndex->pLCP[best] == 0) {
+        return StringInit();
+    }
+    
+    return StringInitWithBytes((const char *)pIndex->pText + pIndex->pSuffixes[best], pIndex->pLCP[best]);
+}
+
+#pragma mark - Save
+
+// The file holds the text, the suffix array and the LCP array in native byte order
+bool StringIndexSave(const StringIndex *pIndex, const char *pPath) {
+    if (!pIndex || !pPath) {
+        return false;
+    }
+    
+    FILE *pFile = fopen(pPath, "wb");
+    if (!pFile) {
+        return false;
+    }
+    
+    IndexFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic));
+    header.byteOrder = INDEX_FILE_BYTE_ORDER;
+    header.intSize = sizeof(int);
+    header.length = pIndex->length;
+    
+    size_t length = (size_t)pIndex->length;
+    size_t padding = suffixesOffset(length) - sizeof(IndexFileHeader) - length;
+    static const char zeros[4] = {0};
+    
+    bool isWritten = fwrite(&header, sizeof(header), 1, pFile) == 1 &&
+                     (length == 0 || fwrite(pIndex->pText, 1, length, pFile) == length) &&
+                     fwrite(zeros, 1, padding, pFile) == padding &&
+                     fwrite(pIndex->pSuffixes, sizeof(int), length, pFile) == length &&
+                     fwrite(pIndex->pLCP, sizeof(int), length, pFile) == length;
+    
+    return fclose(pFile) == 0 && isWritten;
+}
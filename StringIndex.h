@@ -0,0 +1,49 @@
+//
+//  StringIndex.h
+//  DataStructure
+//
+
+#ifndef __StringIndex__
+#define __StringIndex__
+
+#include <stdio.h>
+#include "String.h"
+
+// Suffix array and LCP array of a fixed text, for many substring queries against it.
+// Building is linear (SA-IS, then Kasai for the LCP array), a query is O(m log n) for a pattern of length m.
+// An index can be saved to a file and loaded back, regular files are mapped into memory where the platform allows.
+
+#pragma mark - Type Definition
+
+typedef struct _string_index StringIndex;
+
+#pragma mark - Make Index
+
+// The index shares pStr's buffer, changes to pStr don't affect it, return NULL if memory is not enough
+StringIndex *StringIndexInit(const String *pStr);
+// Map the file if possible, read it otherwise, return NULL if it is not a saved index of this platform
+StringIndex *StringIndexLoad(const char *pPath);
+void StringIndexDestroy(StringIndex *pIndex);
+
+#pragma mark - Get Properties
+
+// Length of the text
+int StringIndexLength(const StringIndex *pIndex);
+
+#pragma mark - Query
+
+bool StringIndexContains(const StringIndex *pIndex, const String *pSub);
+// Count of occurrences including overlapping ones, the empty string occurs length + 1 times, return -2 if parameters invalid
+int  StringIndexCount(const StringIndex *pIndex, const String *pSub);
+// Return Array of int, the indexes of all occurrences including overlapping ones in ascending order,
+// 0 to length for the empty string, return NULL if parameters invalid or memory is not enough
+Array *StringIndexLocate(const StringIndex *pIndex, const String *pSub);
+// Return the longest substring occurring at least twice, empty if there is none, return NULL if parameters invalid
+String *StringIndexLongestRepeatedSubString(const StringIndex *pIndex);
+
+#pragma mark - Save
+
+// The file holds the text, the suffix array and the LCP array in native byte order
+bool StringIndexSave(const StringIndex *pIndex, const char *pPath);
+
+#endif
@@ -0,0 +1,362 @@
+//
+//  StringPool.c
+//  DataStructure
+//
+
+#include "StringPool.h"
+#include <stdatomic.h>
+#include <limits.h>
+#include <stdint.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POOL_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Pool Structure
+
+#define POOL_CHUNK_SIZE 65536
+#define POOL_INITIAL_SLOTS 64
+// Interned strings start on this boundary
+#define POOL_ALIGNMENT 16
+// Spins on a held lock before giving up the time slice
+#define POOL_SPIN_LIMIT 64
+
+// Arena chunk, the entries follow the header
+typedef struct _pool_chunk {
+    struct _pool_chunk *pNext;
+    size_t used;
+    size_t size;
+} PoolChunk;
+
+// An empty slot has pStr NULL
+typedef struct _pool_slot {
+    uint64_t hash;
+    String *pStr;
+} PoolSlot;
+
+struct _string_pool {
+    PoolChunk *pChunks;
+    PoolSlot *pSlots;
+    // Power of 2
+    int slotCount;
+    int count;
+    bool isThreadSafe;
+    atomic_bool isLocked;
+};
+
+#pragma mark - Inner Function
+
+// Spin while the lock looks held, pausing the CPU and yielding to the holder, which may be rehashing
+static void poolLock(StringPool *pPool) {
+    if (!pPool->isThreadSafe) {
+        return;
+    }
+    
+    int spins = 0;
+    while (atomic_exchange_explicit(&pPool->isLocked, true, memory_order_acquire)) {
+        // Only read while waiting, so the cache line isn't taken from the holder
+        while (atomic_load_explicit(&pPool->isLocked, memory_order_relaxed)) {
+            if (++spins < POOL_SPIN_LIMIT) {
+#ifdef POOL_SSE2
+                _mm_pause();
+#endif
+            } else {
+                spins = 0;
+#ifdef _WIN32
+                SwitchToThread();
+#else
+                sched_yield();
+#endif
+            }
+        }
+    }
+}
+
+static void poolUnlock(StringPool *pPool) {
+    if (pPool->isThreadSafe) {
+        atomic_store_explicit(&pPool->isLocked, false, memory_order_release);
+    }
+}
+
+static size_t chunkHeaderSize() {
+    return (sizeof(PoolChunk) + POOL_ALIGNMENT - 1) & ~(size_t)(POOL_ALIGNMENT - 1);
+}
+
+// Copy the bytes into the arena behind a String header, return NULL if memory is not enough
+static String *poolStore(StringPool *pPool, const char *pBytes, int length) {
+    size_t entrySize = (sizeof(String) + length + 1 + POOL_ALIGNMENT - 1) & ~(size_t)(POOL_ALIGNMENT - 1);
+    
+    PoolChunk *pChunk = pPool->pChunks;
+    if (!pChunk || pChunk->size - pChunk->used < entrySize) {
+        size_t size = chunkHeaderSize() + entrySize;
+        if (size < POOL_CHUNK_SIZE) {
+            size = POOL_CHUNK_SIZE;
+        }
+        
+        PoolChunk *pNewChunk = malloc(size);
+        if (!pNewChunk) {
+            return NULL;
+        }
+        pNewChunk->used = chunkHeaderSize();
+        pNewChunk->size = size;
+        
+        if (pChunk && entrySize > POOL_CHUNK_SIZE / 2) {
+            // Keep filling the current chunk, the oversized entry has one for itself
+            pNewChunk->pNext = pChunk->pNext;
+            pChunk->pNext = pNewChunk;
+        } else {
+            pNewChunk->pNext = pChunk;
+            pPool->pChunks = pNewChunk;
+        }
+        pChunk = pNewChunk;
+    }
+    
+    String *pStr = (String *)((char *)pChunk + pChunk->used);
+    pChunk->used += entrySize;
+    
+    char *pData = (char *)(pStr + 1);
+    if (length > 0) {
+        memcpy(pData, pBytes, length);
+    }
+    pData[length] = '\0';
+    
+    pStr->pData = pData;
+    pStr->length = length;
+    pStr->itemSize = sizeof(char);
+    // The '\0' after the string counts as capacity, see StringCStringView
+    pStr->capacity = length + 1;
+    // The bytes belong to the arena, copies of the string copy them
+    pStr->pBuffer = NULL;
+    
+    return pStr;
+}
+
+// Return the slot holding the bytes, or the empty slot where they belong
+static PoolSlot *poolProbe(const StringPool *pPool, uint64_t hash, const char *pBytes, int length) {
+    int mask = pPool->slotCount - 1;
+    for (int i = (int)(hash & mask);; i = (i + 1) & mask) {
+        PoolSlot *pSlot = pPool->pSlots + i;
+        if (!pSlot->pStr) {
+            return pSlot;
+        }
+        if (pSlot->hash == hash && pSlot->pStr->length == length
+            && (length == 0 || !memcmp(pSlot->pStr->pData, pBytes, length))) {
+            return pSlot;
+        }
+    }
+}
+
+// Double the table, the strings themselves never move
+static bool poolGrow(StringPool *pPool) {
+    if (pPool->slotCount > INT_MAX / 2) {
+        return false;
+    }
+    
+    int newSlotCount = pPool->slotCount * 2;
+    PoolSlot *pNewSlots = calloc(newSlotCount, sizeof(PoolSlot));
+    if (!pNewSlots) {
+        return false;
+    }
+    
+    int mask = newSlotCount - 1;
+    for (int i = 0; i < pPool->slotCount; i++) {
+        PoolSlot *pSlot = pPool->pSlots + i;
+        if (!pSlot->pStr) {
+            continue;
+        }
+        int j = (int)(pSlot->hash & mask);
+        while (pNewSlots[j].pStr) {
+            j = (j + 1) & mask;
+        }
+        pNewSlots[j] = *pSlot;
+    }
+    
+    free(pPool->pSlots);
+    pPool->pSlots = pNewSlots;
+    pPool->slotCount = newSlotCount;
+    
+    return true;
+}
+
+static StringPool *poolInit(bool isThreadSafe) {
+    StringPool *pPool = malloc(sizeof(StringPool));
+    if (!pPool) {
+        return NULL;
+    }
+    
+    pPool->pSlots = calloc(POOL_INITIAL_SLOTS, sizeof(PoolSlot));
+    if (!pPool->pSlots) {
+        free(pPool);
+        return NULL;
+    }
+    
+    pPool->pChunks = NULL;
+    pPool->slotCount = POOL_INITIAL_SLOTS;
+    pPool->count = 0;
+    pPool->isThreadSafe = isThreadSafe;
+    atomic_init(&pPool->isLocked, false);
+    
+    return pPool;
+}
+
+#pragma mark - Make Pool
+
+StringPool *StringPoolInit() {
+    return poolInit(false);
+}
+
+// All functions except Destroy can be called from any thread at the same time
+StringPool *StringPoolInitThreadSafe() {
+    return poolInit(true);
+}
+
+// No other thread should be using the pool
+void StringPoolDestroy(StringPool *pPool) {
+    if (!pPool) {
+        return;
+    }
+    
+    PoolChunk *pChunk = pPool->pChunks;
+    while (pChunk) {
+        PoolChunk *pNext = pChunk->pNext;
+        free(pChunk);
+        pChunk = pNext;
+    }
+    
+    free(pPool->pSlots);
+    free(pPool);
+}
+
+#pragma mark - Get Properties
+
+// Number of distinct strings interned, return -1 if pPool is NULL
+int StringPoolCount(StringPool *pPool) {
+    if (!pPool) {
+        return -1;
+    }
+    
+    poolLock(pPool);
+    int count = pPool->count;
+    poolUnlock(pPool);
+    
+    return count;
+}
+
+#pragma mark - Intern
+
+// Return NULL if parameters invalid or memory is not enough
+const String *StringPoolIntern(StringPool *pPool, const String *pStr) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    return StringPoolInternBytes(pPool, pStr->pData, pStr->length);
+}
+
+// Return NULL if parameters invalid or memory is not enough
+const String *StringPoolInternCString(StringPool *pPool, const char *pCStr) {
+    if (!pCStr) {
+        return NULL;
+    }
+    
+    size_t length = strlen(pCStr);
+    if (length > INT_MAX) {
+        return NULL;
+    }
+    
+    return StringPoolInternBytes(pPool, pCStr, (int)length);
+}
+
+// Return NULL if parameters invalid or memory is not enough
+const String *StringPoolInternBytes(StringPool *pPool, const char *pBytes, int length) {
+    if (!pPool || length < 0 || (!pBytes && length > 0)) {
+        return NULL;
+    }
+    
+    uint64_t hash = StringHashBytes(pBytes, length);
+    
+    poolLock(pPool);
+    
+    PoolSlot *pSlot = poolProbe(pPool, hash, pBytes, length);
+    if (pSlot->pStr) {
+        String *pFound = pSlot->pStr;
+        poolUnlock(pPool);
+        return pFound;
+    }
+    
+    // Keep the load factor under 3/4
+    if ((pPool->count + 1) * 4 > pPool->slotCount * 3) {
+        if (!poolGrow(pPool)) {
+            poolUnlock(pPool);
+            return NULL;
+        }
+        pSlot = poolProbe(pPool, hash, pBytes, length);
+    }
+    
+    String *pNew = poolStore(pPool, pBytes, length);
+    if (pNew) {
+        pSlot->hash = hash;
+        pSlot->pStr = pNew;
+        pPool->count++;
+    }
+    
+    poolUnlock(pPool);
+    
+    return pNew;
+}
+
+#pragma mark - Lookup
+
+// Return NULL if the string is not interned
+const String *StringPoolLookup(StringPool *pPool, const String *pStr) {
+    if (!pStr) {
+        return NULL;
+    }
+    
+    return StringPoolLookupBytes(pPool, pStr->pData, pStr->length);
+}
+
+// Return NULL if the string is not interned
+const String *StringPoolLookupCString(StringPool *pPool, const char *pCStr) {
+    if (!pCStr) {
+        return NULL;
+    }
+    
+    size_t length = strlen(pCStr);
+    if (length > INT_MAX) {
+        return NULL;
+    }
+    
+    return StringPoolLookupBytes(pPool, pCStr, (int)length);
+}
+
+// Return NULL if the string is not interned
+const String *StringPoolLookupBytes(StringPool *pPool, const char *pBytes, int length) {
+    if (!pPool || length < 0 || (!pBytes && length > 0)) {
+        return NULL;
+    }
+    
+    uint64_t hash = StringHashBytes(pBytes, length);
+    
+    poolLock(pPool);
+    String *pFound = poolProbe(pPool, hash, pBytes, length)->pStr;
+    poolUnlock(pPool);
+    
+    return pFound;
+}
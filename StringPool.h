@@ -0,0 +1,51 @@
+//
+//  StringPool.h
+//  DataStructure
+//
+
+#ifndef __StringPool__
+#define __StringPool__
+
+#include <stdio.h>
+#include "String.h"
+
+// Interns byte sequences into an arena, every distinct sequence is stored once.
+// Interned strings stay valid until the pool is destroyed, don't modify or destroy them.
+// Two strings interned by the same pool are equal if and only if their pointers are equal.
+
+#pragma mark - Type Definition
+
+typedef struct _string_pool StringPool;
+
+#pragma mark - Make Pool
+
+StringPool *StringPoolInit();
+// All functions except Destroy can be called from any thread at the same time
+StringPool *StringPoolInitThreadSafe();
+// No other thread should be using the pool
+void StringPoolDestroy(StringPool *pPool);
+
+#pragma mark - Get Properties
+
+// Number of distinct strings interned, return -1 if pPool is NULL
+int StringPoolCount(StringPool *pPool);
+
+#pragma mark - Intern
+
+// Return NULL if parameters invalid or memory is not enough
+const String *StringPoolIntern(StringPool *pPool, const String *pStr);
+// Return NULL if parameters invalid or memory is not enough
+const String *StringPoolInternCString(StringPool *pPool, const char *pCStr);
+// Return NULL if parameters invalid or memory is not enough
+const String *StringPoolInternBytes(StringPool *pPool, const char *pBytes, int length);
+
+#pragma mark - Lookup
+
+// Return NULL if the string is not interned
+const String *StringPoolLookup(StringPool *pPool, const String *pStr);
+// Return NULL if the string is not interned
+const String *StringPoolLookupCString(StringPool *pPool, const char *pCStr);
+// Return NULL if the string is not interned
+const String *StringPoolLookupBytes(StringPool *pPool, const char *pBytes, int length);
+
+#endif
@@ -0,0 +1,391 @@
+//
+//  StringReader.c
+//  DataStructure
+//
+
+#include "StringReader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+#define READER_BUFFER_SIZE (1 << 17)
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - Reader Structure
+
+struct _string_reader {
+    // Source of a buffered reader, pFile is NULL when reading fd
+    FILE *pFile;
+    int fd;
+    // Close the source on destroy, set for readers made from a path
+    bool ownsSource;
+    // The whole file when mapped, else a buffer of bufferSize bytes and one more for a '\0'
+    char *pData;
+    size_t bufferSize;
+    bool mapped;
+    // Unread bytes are pData[start, end)
+    size_t start;
+    size_t end;
+    bool atEnd;
+    bool failed;
+    // Header of the record returned as a view of pData
+    String *pView;
+    // Record that did not fit in the buffer
+    String *pLong;
+};
+
+#pragma mark - Inner Function
+
+static StringReader *readerInit(FILE *pFile, int fd, bool ownsSource) {
+    StringReader *pReader = malloc(sizeof(StringReader));
+    if (!pReader) {
+        return NULL;
+    }
+    
+    pReader->pFile = pFile;
+    pReader->fd = fd;
+    pReader->ownsSource = ownsSource;
+    pReader->pData = NULL;
+    pReader->bufferSize = READER_BUFFER_SIZE;
+    pReader->mapped = false;
+    pReader->start = 0;
+    pReader->end = 0;
+    pReader->atEnd = false;
+    pReader->failed = false;
+    pReader->pView = StringInit();
+    pReader->pLong = StringInit();
+    
+    if (!pReader->pView || !pReader->pLong) {
+        StringDestroy(pReader->pView);
+        StringDestroy(pReader->pLong);
+        free(pReader);
+        return NULL;
+    }
+    
+    return pReader;
+}
+
+#ifndef _WIN32
+// Map a regular file, return false to read it through the buffer instead
+static bool readerMap(StringReader *pReader, int fd) {
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0 || (unsigned long long)info.st_size > SIZE_MAX) {
+        return false;
+    }
+    
+    size_t size = (size_t)info.st_size;
+    void *pMap = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pMap == MAP_FAILED) {
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(pMap, size, MADV_SEQUENTIAL);
+#endif
+    
+    pReader->pData = pMap;
+    pReader->mapped = true;
+    pReader->end = size;
+    pReader->atEnd = true;
+    
+    return true;
+}
+#endif
+
+// Move the unread bytes to the front and read more after them, set atEnd at the end of input or on error
+static void readerFill(StringReader *pReader) {
+    if (!pReader->pData) {
+        pReader->pData = malloc(pReader->bufferSize + 1);
+        if (!pReader->pData) {
+            pReader->failed = true;
+            pReader->atEnd = true;
+            return;
+        }
+    }
+    
+    if (pReader->start > 0) {
+        size_t unread = pReader->end - pReader->start;
+        memmove(pReader->pData, pReader->pData + pReader->start, unread);
+        pReader->start = 0;
+        pReader->end = unread;
+    }
+    
+    char *pDest = pReader->pData + pReader->end;
+    size_t room = pReader->bufferSize - pReader->end;
+    
+    if (pReader->pFile) {
+        size_t count = fread(pDest, 1, room, pReader->pFile);
+        pReader->end += count;
+        if (count < room) {
+            pReader->atEnd = true;
+            pReader->failed = ferror(pReader->pFile) != 0;
+        }
+        return;
+    }
+    
+    for (;;) {
+#ifdef _WIN32
+        int count = _read(pReader->fd, pDest, room > INT_MAX ? INT_MAX : (unsigned int)room);
+#else
+        ssize_t count = read(pReader->fd, pDest, room);
+#endif
+        if (count > 0) {
+            pReader->end += (size_t)count;
+            return;
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        
+        pReader->atEnd = true;
+        pReader->failed = count < 0;
+        return;
+    }
+}
+
+// Point the view at length bytes of pData, dropping a '\r' before a '\n' delimiter
+static const String *readerView(StringReader *pReader, char *pRecord, size_t length, char delimiter) {
+    if (delimiter == '\n' && length > 0 && pRecord[length - 1] == '\r') {
+        length--;
+    }
+    if (length >= INT_MAX) {
+        pReader->failed = true;
+        pReader->atEnd = true;
+        pReader->start = pReader->end;
+        return NULL;
+    }
+    
+    // Release storage a previous view was copied into by StringCStringView
+    StringClear(pReader->pView);
+    
+    String *pView = pReader->pView;
+    pView->pData = pRecord;
+    pView->length = (int)length;
+    pView->pBuffer = NULL;
+    if (pReader->mapped) {
+        pView->capacity = (int)length;
+    } else {
+        // The delimiter, the '\r' or the spare byte after the buffer is overwritten, see StringCStringView
+        pRecord[length] = '\0';
+        pView->capacity = (int)length + 1;
+    }
+    
+    return pView;
+}
+
+// Collect a record longer than the buffer into pLong, the buffer is full when called
+static const String *readerReadLong(StringReader *pReader, char delimiter) {
+    String *pLong = pReader->pLong;
+    // Keep the storage of the last long record, appending copies it first if the caller shares it
+    pLong->length = 0;
+    
+    for (;;) {
+        char *pBegin = pReader->pData + pReader->start;
+        size_t unread = pReader->end - pReader->start;
+        char *pDelim = unread > 0 ? memchr(pBegin, delimiter, unread) : NULL;
+        size_t count = pDelim ? (size_t)(pDelim - pBegin) : unread;
+        
+        if (count > (size_t)(INT_MAX - 1 - pLong->length) || !StringAppendBytes(pLong, pBegin, (int)count)) {
+            pReader->failed = true;
+            pReader->atEnd = true;
+            pReader->start = pReader->end;
+            return NULL;
+        }
+        
+        if (pDelim) {
+            pReader->start += count + 1;
+            break;
+        }
+        pReader->start = pReader->end;
+        
+        if (pReader->atEnd) {
+            break;
+        }
+        readerFill(pReader);
+        if (pReader->failed) {
+            return NULL;
+        }
+    }
+    
+    // The '\r' may have come in the chunk before the '\n'
+    if (delimiter == '\n' && pLong->length > 0 && ((char *)pLong->pData)[pLong->length - 1] == '\r') {
+        pLong->length--;
+    }
+    
+    return pLong;
+}
+
+#pragma mark - Make Reader
+
+// Map the file if it is a regular file, read it through the buffer otherwise, return NULL if it can't be opened
+StringReader *StringReaderInitWithPath(const char *pPath) {
+    if (!pPath) {
+        return NULL;
+    }
+    
+#ifdef _WIN32
+    FILE *pFile = fopen(pPath, "rb");
+    if (!pFile) {
+        return NULL;
+    }
+    
+    StringReader *pReader = readerInit(pFile, -1, true);
+    if (!pReader) {
+        fclose(pFile);
+    }
+    
+    return pReader;
+#else
+    int fd;
+    do {
+        fd = open(pPath, O_RDONLY);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    StringReader *pReader = readerInit(NULL, fd, true);
+    if (!pReader) {
+        close(fd);
+        return NULL;
+    }
+    
+    // The mapping stays valid after the descriptor is closed
+    if (readerMap(pReader, fd)) {
+        close(fd);
+        pReader->fd = -1;
+        pReader->ownsSource = false;
+    }
+    
+    return pReader;
+#endif
+}
+
+// The file descriptor is not closed by the reader
+StringReader *StringReaderInitWithFd(int fd) {
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    return readerInit(NULL, fd, false);
+}
+
+// The file is not closed by the reader, it is read through its own buffer as well, so prefer a path or fd
+StringReader *StringReaderInitWithFile(FILE *pFile) {
+    if (!pFile) {
+        return NULL;
+    }
+    
+    return readerInit(pFile, -1, false);
+}
+
+void StringReaderDestroy(StringReader *pReader) {
+    if (!pReader) {
+        return;
+    }
+    
+#ifndef _WIN32
+    if (pReader->mapped) {
+        munmap(pReader->pData, pReader->end);
+    } else
+#endif
+    {
+        free(pReader->pData);
+    }
+    
+    if (pReader->ownsSource) {
+        if (pReader->pFile) {
+            fclose(pReader->pFile);
+        } else {
+#ifdef _WIN32
+            _close(pReader->fd);
+#else
+            close(pReader->fd);
+#endif
+        }
+    }
+    
+    // The view only borrows pData, destroying it frees what StringCStringView may have copied
+    StringDestroy(pReader->pView);
+    StringDestroy(pReader->pLong);
+    free(pReader);
+}
+
+#pragma mark - Read
+
+// Return the next line without its "\n" or "\r\n", return NULL at the end of input or on error
+// The string is valid until the next read or the reader is destroyed, don't modify or destroy it
+const String *StringReaderReadLine(StringReader *pReader) {
+    return StringReaderReadRecord(pReader, '\n');
+}
+
+// Return the next record without its delimiter, return NULL at the end of input or on error
+// The string is valid until the next read or the reader is destroyed, don't modify or destroy it
+const String *StringReaderReadRecord(StringReader *pReader, char delimiter) {
+    if (!pReader || pReader->failed) {
+        return NULL;
+    }
+    
+    // Buffered readers allocate the buffer on the first read
+    if (!pReader->pData) {
+        readerFill(pReader);
+        if (pReader->failed) {
+            return NULL;
+        }
+    }
+    
+    for (;;) {
+        char *pBegin = pReader->pData + pReader->start;
+        size_t unread = pReader->end - pReader->start;
+        char *pDelim = unread > 0 ? memchr(pBegin, delimiter, unread) : NULL;
+        
+        if (pDelim) {
+            size_t length = (size_t)(pDelim - pBegin);
+            pReader->start += length + 1;
+            return readerView(pReader, pBegin, length, delimiter);
+        }
+        
+        if (pReader->atEnd) {
+            if (unread == 0) {
+                return NULL;
+            }
+            // The last record has no delimiter
+            pReader->start = pReader->end;
+            return readerView(pReader, pBegin, unread, delimiter);
+        }
+        
+        if (unread == pReader->bufferSize) {
+            return readerReadLong(pReader, delimiter);
+        }
+        
+        readerFill(pReader);
+        if (pReader->failed) {
+            return NULL;
+        }
+    }
+}
+
+#pragma mark - Get Properties
+
+// Whether a read failed, reads return NULL after a failure
+bool StringReaderHasError(const StringReader *pReader) {
+    return !pReader || pReader->failed;
+}
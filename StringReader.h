@@ -0,0 +1,45 @@
+//
+//  StringReader.h
+//  DataStructure
+//
+
+#ifndef __StringReader__
+#define __StringReader__
+
+#include <stdio.h>
+#include "String.h"
+
+// Reads lines or delimiter separated records from a file through one large reusable buffer,
+// regular files opened by path are mapped into memory where the platform allows.
+// A record that fits in the buffer is returned as a view of the buffer without copying,
+// a longer one is collected into a String the reader owns.
+
+#pragma mark - Type Definition
+
+typedef struct _string_reader StringReader;
+
+#pragma mark - Make Reader
+
+// Map the file if it is a regular file, read it through the buffer otherwise, return NULL if it can't be opened
+StringReader *StringReaderInitWithPath(const char *pPath);
+// The file descriptor is not closed by the reader
+StringReader *StringReaderInitWithFd(int fd);
+// The file is not closed by the reader, it is read through its own buffer as well, so prefer a path or fd
+StringReader *StringReaderInitWithFile(FILE *pFile);
+void StringReaderDestroy(StringReader *pReader);
+
+#pragma mark - Read
+
+// Return the next line without its "\n" or "\r\n", return NULL at the end of input or on error
+// The string is valid until the next read or the reader is destroyed, don't modify or destroy it
+const String *StringReaderReadLine(StringReader *pReader);
+// Return the next record without its delimiter, return NULL at the end of input or on error
+// The string is valid until the next read or the reader is destroyed, don't modify or destroy it
+const String *StringReaderReadRecord(StringReader *pReader, char delimiter);
+
+#pragma mark - Get Properties
+
+// Whether a read failed, reads return NULL after a failure
+bool StringReaderHasError(const StringReader *pReader);
+
+#endif
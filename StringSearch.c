@@ -0,0 +1,480 @@
+//
+//  StringSearch.c
+//  DataStructure
+//
+
+#include "StringSearch.h"
+#include <limits.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SEARCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#pragma mark - Dynamic Array Structure
+
+struct _dynamic_array {
+    void *pData;
+    int length;
+    int itemSize;
+    int capacity;
+    // Reference counted storage pData points into, NULL if pData is NULL or borrowed from other storage
+    struct _array_buffer *pBuffer;
+};
+
+#pragma mark - String Searcher Structure
+
+// Longer patterns use Horspool, shorter ones the first/last character filter
+#define SHORT_PATTERN_MAX_LENGTH 32
+
+struct _string_searcher {
+    char *pSub;
+    int length;
+    // Horspool shift tables, only for long patterns
+    int *pShift;
+    int *pReverseShift;
+};
+
+struct _string_stream_searcher {
+    StringSearcher *pSearcher;
+    // The last length - 1 bytes fed, the first half of pWindow
+    char *pWindow;
+    int carryLength;
+    // Stream offset of the first carried byte
+    long long carryStart;
+    long long position;
+    // Matches should start here or later, so they don't overlap
+    long long nextStart;
+};
+
+#pragma mark - Inner Function
+
+static int countTrailingZeros(unsigned int mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static void buildShift(const unsigned char *pSub, int length, int *pShift) {
+    for (int c = 0; c < 256; c++) {
+        pShift[c] = length;
+    }
+    for (int i = 0; i < length - 1; i++) {
+        pShift[pSub[i]] = length - 1 - i;
+    }
+}
+
+// Mirror of buildShift, for searching backward
+static void buildReverseShift(const unsigned char *pSub, int length, int *pReverseShift) {
+    for (int c = 0; c < 256; c++) {
+        pReverseShift[c] = length;
+    }
+    for (int i = length - 1; i > 0; i--) {
+        pReverseShift[pSub[i]] = i;
+    }
+}
+
+// Find candidates whose first and last characters match, then compare the middle
+static int searchShort(const char *pData, int length, const char *pSub, int subLength, int start) {
+    const char first = pSub[0];
+    const char last = pSub[subLength - 1];
+    int i = start;
+    
+#ifdef STRING_SEARCH_SSE2
+    const __m128i firstVec = _mm_set1_epi8(first);
+    const __m128i lastVec = _mm_set1_epi8(last);
+    for (; i + subLength - 1 + 16 <= length; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128((const __m128i *)(pData + i));
+        __m128i blockLast = _mm_loadu_si128((const __m128i *)(pData + i + subLength - 1));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstVec),
+                                                                           _mm_cmpeq_epi8(blockLast, lastVec)));
+        while (mask) {
+            int offset = countTrailingZeros(mask);
+            if (subLength <= 2 || 0 == memcmp(pData + i + offset + 1, pSub + 1, subLength - 2)) {
+                return i + offset;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    
+    const char *pEnd = pData + length - subLength + 1;
+    for (const char *p = pData + i; p < pEnd && (p = memchr(p, first, pEnd - p)); p++) {
+        if (p[subLength - 1] == last && 0 == memcmp(p + 1, pSub + 1, subLength > 2 ? subLength - 2 : 0)) {
+            return (int)(p - pData);
+        }
+    }
+    
+    return -1;
+}
+
+static int searchHorspool(const char *pData, int length, const char *pSub, int subLength, int start, const int *pShift) {
+    const unsigned char *pText = (const unsigned char *)pData;
+    const unsigned char last = (unsigned char)pSub[subLength - 1];
+    
+    for (int i = start; i <= length - subLength; ) {
+        unsigned char c = pText[i + subLength - 1];
+        if (c == last && 0 == memcmp(pData + i, pSub, subLength - 1)) {
+            return i;
+        }
+        i += pShift[c];
+    }
+    
+    return -1;
+}
+
+static int searchLastHorspool(const char *pData, int length, const char *pSub, int subLength, const int *pReverseShift) {
+    const unsigned char *pText = (const unsigned char *)pData;
+    const unsigned char first = (unsigned char)pSub[0];
+    
+    for (int i = length - subLength; i >= 0; ) {
+        unsigned char c = pText[i];
+        if (c == first && 0 == memcmp(pData + i + 1, pSub + 1, subLength - 1)) {
+            return i;
+        }
+        i -= pReverseShift[c];
+    }
+    
+    return -1;
+}
+
+static int searchLastShort(const char *pData, int length, const char *pSub, int subLength) {
+    for (int i = length - subLength; i >= 0; i--) {
+        if (pData[i] == pSub[0] && pData[i + subLength - 1] == pSub[subLength - 1] &&
+            0 == memcmp(pData + i, pSub, subLength)) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+// Handle the cases every search path shares, return -3 if the real search is needed
+static int searchTrivial(const char *pData, int length, const char *pSub, int subLength, int start) {
+    if ((!pData && length > 0) || (!pSub && subLength > 0) || length < 0 || subLength < 0) {
+        return -2;
+    }
+    
+    if (start < 0 || start > length) {
+        return -2;
+    }
+    
+    if (subLength == 0) {
+        return start;
+    }
+    
+    if (length - start < subLength) {
+        return -1;
+    }
+    
+    if (subLength == 1) {
+        const char *p = memchr(pData + start, pSub[0], length - start);
+        return p ? (int)(p - pData) : -1;
+    }
+    
+    return -3;
+}
+
+#pragma mark - Make Searcher
+
+StringSearcher *StringSearcherInit(const String *pSub) {
+    if (!pSub) {
+        return NULL;
+    }
+    
+    return StringSearcherInitWithBytes(pSub->pData, pSub->length);
+}
+
+StringSearcher *StringSearcherInitWithCString(const char *pCSub) {
+    if (!pCSub) {
+        return NULL;
+    }
+    
+    return StringSearcherInitWithBytes(pCSub, (int)strlen(pCSub));
+}
+
+StringSearcher *StringSearcherInitWithBytes(const char *pSub, int length) {
+    if ((!pSub && length > 0) || length < 0) {
+        return NULL;
+    }
+    
+    StringSearcher *pSearcher = malloc(sizeof(StringSearcher));
+    if (!pSearcher) {
+        return NULL;
+    }
+    
+    pSearcher->length = length;
+    pSearcher->pShift = NULL;
+    pSearcher->pReverseShift = NULL;
+    pSearcher->pSub = malloc(length + 1);
+    if (!pSearcher->pSub) {
+        free(pSearcher);
+        return NULL;
+    }
+    
+    if (length > 0) {
+        memcpy(pSearcher->pSub, pSub, length);
+    }
+    
+    if (length > SHORT_PATTERN_MAX_LENGTH) {
+        pSearcher->pShift = malloc(2 * 256 * sizeof(int));
+        if (!pSearcher->pShift) {
+            StringSearcherDestroy(pSearcher);
+            return NULL;
+        }
+        pSearcher->pReverseShift = pSearcher->pShift + 256;
+        buildShift((const unsigned char *)pSub, length, pSearcher->pShift);
+        buildReverseShift((const unsigned char *)pSub, length, pSearcher->pReverseShift);
+    }
+    
+    return pSearcher;
+}
+
+void StringSearcherDestroy(StringSearcher *pSearcher) {
+    if (!pSearcher) {
+        return;
+    }
+    
+    free(pSearcher->pSub);
+    free(pSearcher->pShift);
+    free(pSearcher);
+}
+
+#pragma mark - Get Properties
+
+int StringSearcherLength(const StringSearcher *pSearcher) {
+    return pSearcher ? pSearcher->length : -1;
+}
+
+#pragma mark - Search
+
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFind(const StringSearcher *pSearcher, const String *pStr, int start) {
+    if (!pSearcher || !pStr) {
+        return -2;
+    }
+    
+    return StringSearcherFindInBytes(pSearcher, pStr->pData, pStr->length, start);
+}
+
+// Return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFindLast(const StringSearcher *pSearcher, const String *pStr) {
+    if (!pSearcher || !pStr) {
+        return -2;
+    }
+    
+    return StringSearcherFindLastInBytes(pSearcher, pStr->pData, pStr->length);
+}
+
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFindInBytes(const StringSearcher *pSearcher, const char *pData, int length, int start) {
+    if (!pSearcher) {
+        return -2;
+    }
+    
+    int index = searchTrivial(pData, length, pSearcher->pSub, pSearcher->length, start);
+    if (index != -3) {
+        return index;
+    }
+    
+    if (pSearcher->pShift) {
+        return searchHorspool(pData, length, pSearcher->pSub, pSearcher->length, start, pSearcher->pShift);
+    }
+    
+    return searchShort(pData, length, pSearcher->pSub, pSearcher->length, start);
+}
+
+// Return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFindLastInBytes(const StringSearcher *pSearcher, const char *pData, int length) {
+    if (!pSearcher) {
+        return -2;
+    }
+    
+    if (pSearcher->pReverseShift) {
+        int index = searchTrivial(pData, length, pSearcher->pSub, pSearcher->length, 0);
+        if (index != -3) {
+            return index;
+        }
+        return searchLastHorspool(pData, length, pSearcher->pSub, pSearcher->length, pSearcher->pReverseShift);
+    }
+    
+    return StringSearchLastBytes(pData, length, pSearcher->pSub, pSearcher->length);
+}
+
+#pragma mark - Search Once
+
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int StringSearchBytes(const char *pData, int length, const char *pSub, int subLength, int start) {
+    int index = searchTrivial(pData, length, pSub, subLength, start);
+    if (index != -3) {
+        return index;
+    }
+    
+    if (subLength > SHORT_PATTERN_MAX_LENGTH) {
+        int shift[256];
+        buildShift((const unsigned char *)pSub, subLength, shift);
+        return searchHorspool(pData, length, pSub, subLength, start, shift);
+    }
+    
+    return searchShort(pData, length, pSub, subLength, start);
+}
+
+// Return -1 if no such substring, return -2 if parameters invalid
+int StringSearchLastBytes(const char *pData, int length, const char *pSub, int subLength) {
+    int index = searchTrivial(pData, length, pSub, subLength, 0);
+    if (index == -2 || index == -1) {
+        return index;
+    }
+    
+    if (subLength == 0) {
+        return length;
+    }
+    
+    if (subLength > SHORT_PATTERN_MAX_LENGTH) {
+        int reverseShift[256];
+        buildReverseShift((const unsigned char *)pSub, subLength, reverseShift);
+        return searchLastHorspool(pData, length, pSub, subLength, reverseShift);
+    }
+    
+    return searchLastShort(pData, length, pSub, subLength);
+}
+
+#pragma mark - Stream Search
+
+// The pattern should not be empty
+StringStreamSearcher *StringStreamSearcherInit(const String *pSub) {
+    if (!pSub) {
+        return NULL;
+    }
+    
+    return StringStreamSearcherInitWithBytes(pSub->pData, pSub->length);
+}
+
+StringStreamSearcher *StringStreamSearcherInitWithCString(const char *pCSub) {
+    if (!pCSub) {
+        return NULL;
+    }
+    
+    return StringStreamSearcherInitWithBytes(pCSub, (int)strlen(pCSub));
+}
+
+StringStreamSearcher *StringStreamSearcherInitWithBytes(const char *pSub, int length) {
+    if (!pSub || length <= 0 || length > INT_MAX / 2) {
+        return NULL;
+    }
+    
+    StringStreamSearcher *pSearcher = malloc(sizeof(StringStreamSearcher));
+    if (!pSearcher) {
+        return NULL;
+    }
+    
+    pSearcher->pSearcher = StringSearcherInitWithBytes(pSub, length);
+    // Carried bytes plus as many bytes of the next chunk
+    pSearcher->pWindow = malloc(2 * (length - 1) + 1);
+    if (!pSearcher->pSearcher || !pSearcher->pWindow) {
+        StringSearcherDestroy(pSearcher->pSearcher);
+        free(pSearcher->pWindow);
+        free(pSearcher);
+        return NULL;
+    }
+    
+    StringStreamSearcherReset(pSearcher);
+    
+    return pSearcher;
+}
+
+void StringStreamSearcherDestroy(StringStreamSearcher *pSearcher) {
+    if (!pSearcher) {
+        return;
+    }
+    
+    StringSearcherDestroy(pSearcher->pSearcher);
+    free(pSearcher->pWindow);
+    free(pSearcher);
+}
+
+// Forget everything fed, start a new stream
+void StringStreamSearcherReset(StringStreamSearcher *pSearcher) {
+    if (!pSearcher) {
+        return;
+    }
+    
+    pSearcher->carryLength = 0;
+    pSearcher->carryStart = 0;
+    pSearcher->position = 0;
+    pSearcher->nextStart = 0;
+}
+
+// Number of bytes fed since init or reset
+long long StringStreamSearcherPosition(const StringStreamSearcher *pSearcher) {
+    return pSearcher ? pSearcher->position : 0;
+}
+
+// Append to pOffsets (Array of long long) the stream offsets of non-overlapping matches,
+// including the ones spanning earlier chunks, return false if parameters invalid or memory is not enough
+bool StringStreamSearcherFeed(StringStreamSearcher *pSearcher, const char *pChunk, int length, Array *pOffsets) {
+    if (!pSearcher || !pOffsets || pOffsets->itemSize != sizeof(long long) || length < 0 || (!pChunk && length > 0)) {
+        return false;
+    }
+    
+    const StringSearcher *pPattern = pSearcher->pSearcher;
+    int subLength = pPattern->length;
+    long long chunkStart = pSearcher->position;
+    char *pWindow = pSearcher->pWindow;
+    int carryLength = pSearcher->carryLength;
+    
+    // Matches starting in the carried bytes end within the first subLength - 1 bytes of the chunk
+    int headLength = length < subLength - 1 ? length : subLength - 1;
+    if (carryLength > 0) {
+        memcpy(pWindow + carryLength, pChunk, headLength);
+        int windowLength = carryLength + headLength;
+        
+        long long from = pSearcher->nextStart - pSearcher->carryStart;
+        int index = from > 0 ? (int)from : 0;
+        while (index < carryLength && (index = StringSearcherFindInBytes(pPattern, pWindow, windowLength, index)) >= 0 && index < carryLength) {
+            long long offset = pSearcher->carryStart + index;
+            if (!ArrayAppendItem(pOffsets, &offset)) {
+                return false;
+            }
+            pSearcher->nextStart = offset + subLength;
+            index += subLength;
+        }
+    }
+    
+    // Matches starting in the chunk
+    long long from = pSearcher->nextStart - chunkStart;
+    int index = from > 0 ? (int)from : 0;
+    while (index <= length - subLength && (index = StringSearcherFindInBytes(pPattern, pChunk, length, index)) >= 0) {
+        long long offset = chunkStart + index;
+        if (!ArrayAppendItem(pOffsets, &offset)) {
+            return false;
+        }
+        pSearcher->nextStart = offset + subLength;
+        index += subLength;
+    }
+    
+    // Keep the last subLength - 1 bytes of the stream
+    int keep = subLength - 1;
+    if (length >= keep) {
+        memcpy(pWindow, pChunk + length - keep, keep);
+        pSearcher->carryLength = keep;
+    } else {
+        int total = carryLength + length;
+        int dropped = total > keep ? total - keep : 0;
+        memmove(pWindow, pWindow + dropped, carryLength - dropped);
+        memcpy(pWindow + carryLength - dropped, pChunk, length);
+        pSearcher->carryLength = total - dropped;
+    }
+    pSearcher->position += length;
+    pSearcher->carryStart = pSearcher->position - pSearcher->carryLength;
+    
+    return true;
+}
@@ -0,0 +1,66 @@
+//
+//  StringSearch.h
+//  DataStructure
+//
+
+#ifndef __StringSearch__
+#define __StringSearch__
+
+#include <stdio.h>
+#include "String.h"
+
+// Short patterns are searched by SIMD first/last character filter (SSE2 when available),
+// long patterns by Boyer-Moore-Horspool.
+
+#pragma mark - Type Definition
+
+// Precompiled pattern, reuse it when searching the same pattern many times
+typedef struct _string_searcher StringSearcher;
+// Searches input that arrives in chunks, keeps only the last length - 1 bytes between chunks
+typedef struct _string_stream_searcher StringStreamSearcher;
+
+#pragma mark - Make Searcher
+
+StringSearcher *StringSearcherInit(const String *pSub);
+StringSearcher *StringSearcherInitWithCString(const char *pCSub);
+StringSearcher *StringSearcherInitWithBytes(const char *pSub, int length);
+void StringSearcherDestroy(StringSearcher *pSearcher);
+
+#pragma mark - Get Properties
+
+int StringSearcherLength(const StringSearcher *pSearcher);
+
+#pragma mark - Search
+
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFind(const StringSearcher *pSearcher, const String *pStr, int start);
+// Return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFindLast(const StringSearcher *pSearcher, const String *pStr);
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFindInBytes(const StringSearcher *pSearcher, const char *pData, int length, int start);
+// Return -1 if no such substring, return -2 if parameters invalid
+int StringSearcherFindLastInBytes(const StringSearcher *pSearcher, const char *pData, int length);
+
+#pragma mark - Search Once
+
+// Search from index start, return -1 if no such substring, return -2 if parameters invalid
+int StringSearchBytes(const char *pData, int length, const char *pSub, int subLength, int start);
+// Return -1 if no such substring, return -2 if parameters invalid
+int StringSearchLastBytes(const char *pData, int length, const char *pSub, int subLength);
+
+#pragma mark - Stream Search
+
+// The pattern should not be empty
+StringStreamSearcher *StringStreamSearcherInit(const String *pSub);
+StringStreamSearcher *StringStreamSearcherInitWithCString(const char *pCSub);
+StringStreamSearcher *StringStreamSearcherInitWithBytes(const char *pSub, int length);
+void StringStreamSearcherDestroy(StringStreamSearcher *pSearcher);
+// Forget everything fed, start a new stream
+void StringStreamSearcherReset(StringStreamSearcher *pSearcher);
+// Number of bytes fed since init or reset
+long long StringStreamSearcherPosition(const StringStreamSearcher *pSearcher);
+// Append to pOffsets (Array of long long) the stream offsets of non-overlapping matches,
+// including the ones spanning earlier chunks, return false if parameters invalid or memory is not enough
+bool StringStreamSearcherFeed(StringStreamSearcher *pSearcher, const char *pChunk, int length, Array *pOffsets);
+
+#endif